@@ -0,0 +1,19 @@
+# Fail if an executable references the heap: malloc and friends, operator
+# new and delete, or exception objects (which are allocated).
+# Usage: cmake -DNM=<nm> -DBINARY=<executable> -P check_no_heap.cmake
+execute_process(COMMAND "${NM}" "${BINARY}"
+  OUTPUT_VARIABLE symbols
+  RESULT_VARIABLE status)
+if(NOT status EQUAL 0)
+  message(FATAL_ERROR "cannot list the symbols of ${BINARY}")
+endif()
+
+# nm prints "<address> <type> <name>[@<version>]", one symbol per line
+string(REGEX MATCHALL
+  " (malloc|calloc|realloc|free|aligned_alloc|posix_memalign|memalign|__cxa_allocate_exception|_Znw[^\n]*|_Zna[^\n]*|_Zdl[^\n]*|_Zda[^\n]*)(@[^\n]*)?\n"
+  found "${symbols}\n")
+if(found)
+  string(REPLACE "\n" "" found "${found}")
+  message(FATAL_ERROR "${BINARY} pulls in heap allocation:${found}")
+endif()
+message(STATUS "${BINARY}: no heap allocation symbols")
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace micro_mouse {
+
+/**
+ * @brief Command of the binary framing of the simulator protocol
+ *
+ * The text protocol of mms stays the default. A local simulator may offer
+ * the binary framing by answering @c mazeWidth with its width followed by
+ * binary_offer; a client that wants it sends binary_request, and after the
+ * @c ack both sides switch for the rest of the session. mms never makes the
+ * offer, so a client talking to it keeps the text protocol.
+ *
+ * A frame is the command byte followed by its arguments, one byte each:
+ * - x and y for every cell command, then the direction or color character
+ *   of SET_WALL, CLEAR_WALL and SET_COLOR;
+ * - the text length and the text of SET_TEXT, after x and y;
+ * - the distance of MOVE_FORWARD.
+ *
+ * Commands with a reply get a single byte: the size for MAZE_WIDTH and
+ * MAZE_HEIGHT, 1 for a wall, a reset or an acknowledged command, 0 for no
+ * wall, no reset or a crash.
+ */
+enum class FrameOp : std::uint8_t {
+  MAZE_WIDTH = 1,
+  MAZE_HEIGHT,
+  WALL_FRONT,
+  WALL_RIGHT,
+  WALL_LEFT,
+  MOVE_FORWARD,
+  TURN_RIGHT,
+  TURN_LEFT,
+  SET_WALL,
+  CLEAR_WALL,
+  SET_COLOR,
+  CLEAR_COLOR,
+  CLEAR_ALL_COLOR,
+  SET_TEXT,
+  CLEAR_TEXT,
+  CLEAR_ALL_TEXT,
+  WAS_RESET,
+  ACK_RESET
+};
+
+/// Token after the width in the mazeWidth reply of a simulator offering
+/// the binary framing
+constexpr std::string_view binary_offer{"binary"};
+
+/// Text command switching an offering simulator to the binary framing
+constexpr std::string_view binary_request{"useBinary"};
+
+/// Largest maze side the binary framing can address
+constexpr int binary_max_side{255};
+
+/**
+ * @brief Size of a frame before any text
+ * @param op Command
+ * @return Bytes of the command and its fixed arguments, 0 if @p op is not
+ * a command
+ */
+constexpr std::size_t frame_size(FrameOp op) noexcept {
+  switch (op) {
+  case FrameOp::MAZE_WIDTH:
+  case FrameOp::MAZE_HEIGHT:
+  case FrameOp::WALL_FRONT:
+  case FrameOp::WALL_RIGHT:
+  case FrameOp::WALL_LEFT:
+  case FrameOp::TURN_RIGHT:
+  case FrameOp::TURN_LEFT:
+  case FrameOp::CLEAR_ALL_COLOR:
+  case FrameOp::CLEAR_ALL_TEXT:
+  case FrameOp::WAS_RESET:
+  case FrameOp::ACK_RESET:
+    return 1;
+  case FrameOp::MOVE_FORWARD:
+    return 2;
+  case FrameOp::CLEAR_COLOR:
+  case FrameOp::CLEAR_TEXT:
+    return 3;
+  case FrameOp::SET_WALL:
+  case FrameOp::CLEAR_WALL:
+  case FrameOp::SET_COLOR:
+  case FrameOp::SET_TEXT:
+    return 4;
+  }
+  return 0;
+}
+
+} // namespace micro_mouse
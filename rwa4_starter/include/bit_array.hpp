@@ -0,0 +1,141 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micro_mouse {
+
+/**
+ * @brief Fixed-size array of bits packed in 64-bit words
+ *
+ * Besides single-bit access, ranges of up to 64 consecutive bits can be
+ * read or written in one word-wide operation, which is what the maze model
+ * uses for whole-row queries.
+ */
+class BitArray {
+public:
+  /**
+   * @brief Construct an array of cleared bits
+   * @param size Number of bits
+   */
+  explicit BitArray(std::size_t size = 0)
+      : size_{size}, words_((size + 63) / 64, 0) {}
+
+  /**
+   * @brief Get the number of bits
+   * @return Number of bits in the array
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Read one bit
+   * @param i Index of the bit
+   * @return Value of the bit
+   */
+  [[nodiscard]] bool test(std::size_t i) const noexcept {
+    return (words_[i / 64] >> (i % 64)) & 1U;
+  }
+
+  /**
+   * @brief Write one bit
+   * @param i Index of the bit
+   * @param value Value to store
+   */
+  void set(std::size_t i, bool value = true) noexcept {
+    const std::uint64_t bit{std::uint64_t{1} << (i % 64)};
+    if (value) {
+      words_[i / 64] |= bit;
+    } else {
+      words_[i / 64] &= ~bit;
+    }
+  }
+
+  /**
+   * @brief Read up to 64 consecutive bits
+   * @param pos Index of the first bit
+   * @param count Number of bits, 1 to 64
+   * @return The bits, bit @p pos in the least significant position
+   */
+  [[nodiscard]] std::uint64_t extract(std::size_t pos,
+                                      std::size_t count) const noexcept {
+    const std::size_t word{pos / 64};
+    const std::size_t shift{pos % 64};
+    std::uint64_t bits{words_[word] >> shift};
+    if (shift != 0 && shift + count > 64) {
+      bits |= words_[word + 1] << (64 - shift);
+    }
+    return bits & low_mask(count);
+  }
+
+  /**
+   * @brief Set (OR in) up to 64 consecutive bits
+   * @param pos Index of the first bit
+   * @param count Number of bits, 1 to 64
+   * @param bits Bits to set, bit @p pos in the least significant position
+   */
+  void deposit(std::size_t pos, std::size_t count,
+               std::uint64_t bits) noexcept {
+    bits &= low_mask(count);
+    const std::size_t word{pos / 64};
+    const std::size_t shift{pos % 64};
+    words_[word] |= bits << shift;
+    if (shift != 0 && shift + count > 64) {
+      words_[word + 1] |= bits >> (64 - shift);
+    }
+  }
+
+  /**
+   * @brief Clear every bit
+   */
+  void clear() noexcept {
+    for (auto &w : words_) {
+      w = 0;
+    }
+  }
+
+  /**
+   * @brief Count the bits that are set
+   * @return Number of set bits
+   */
+  [[nodiscard]] std::size_t count() const noexcept {
+    std::size_t total{0};
+    for (const auto w : words_) {
+      total += static_cast<std::size_t>(__builtin_popcountll(w));
+    }
+    return total;
+  }
+
+  /**
+   * @brief Access the underlying words
+   * @return Words holding the bits, least significant bit first
+   */
+  [[nodiscard]] const std::vector<std::uint64_t> &words() const noexcept {
+    return words_;
+  }
+
+  /**
+   * @brief Overwrite every word
+   * @param words Source of words().size() words
+   */
+  void assign(const std::uint64_t *words) noexcept {
+    for (std::size_t i{0}; i < words_.size(); ++i) {
+      words_[i] = words[i];
+    }
+  }
+
+  /**
+   * @brief Mask with the @p count least significant bits set
+   * @param count Number of bits, 0 to 64
+   * @return The mask
+   */
+  static constexpr std::uint64_t low_mask(std::size_t count) noexcept {
+    return count >= 64 ? ~std::uint64_t{0}
+                       : (std::uint64_t{1} << count) - 1;
+  }
+
+private:
+  std::size_t size_;
+  std::vector<std::uint64_t> words_;
+}; // class BitArray
+
+} // namespace micro_mouse
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace micro_mouse {
+
+/**
+ * @brief Indexed priority queue of the items 0 to n - 1, keyed by small
+ * non-negative integers
+ *
+ * There is one bucket per key, each a doubly linked list threaded through
+ * arrays indexed by item. Pushing, erasing and re-keying an item therefore
+ * take constant time, and the items can be walked in increasing key order
+ * with first() and next(). Items of equal keys come most recent first.
+ */
+class BucketQueue {
+public:
+  /**
+   * @brief Construct an empty queue
+   * @param items Number of items
+   * @param max_key Largest key
+   */
+  BucketQueue(std::size_t items, int max_key);
+
+  /**
+   * @brief Check if an item is queued
+   * @param item Item
+   * @return true if the item is in the queue
+   */
+  [[nodiscard]] bool contains(int item) const noexcept {
+    return keys_[static_cast<std::size_t>(item)] >= 0;
+  }
+
+  /**
+   * @brief Get the key of an item
+   * @param item Item
+   * @return Its key, -1 if it is not queued
+   */
+  [[nodiscard]] int key(int item) const noexcept {
+    return keys_[static_cast<std::size_t>(item)];
+  }
+
+  /**
+   * @brief Count the queued items
+   * @return Number of items in the queue
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief Queue an item, or change its key if it is queued already
+   * @param item Item
+   * @param key Key, at most the largest key
+   */
+  void push(int item, int key);
+
+  /**
+   * @brief Take an item out of the queue; nothing happens if it is not in
+   * @param item Item
+   */
+  void erase(int item);
+
+  /**
+   * @brief Get an item with the smallest key
+   * @return The item, -1 if the queue is empty
+   */
+  int first() noexcept;
+
+  /**
+   * @brief Get the item after @p item in key order
+   * @param item Queued item
+   * @return The next item, -1 after the last one
+   */
+  [[nodiscard]] int next(int item) const noexcept;
+
+private:
+  std::vector<int> heads_; // First item of each bucket, -1 if empty
+  std::vector<int> next_;
+  std::vector<int> previous_;
+  std::vector<int> keys_;
+  std::size_t size_{0};
+  int lowest_{0}; // No bucket below it holds an item
+}; // class BucketQueue
+
+} // namespace micro_mouse
@@ -0,0 +1,227 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace micro_mouse {
+
+/**
+ * @brief Counters describing the traffic exchanged with the simulator
+ */
+struct ChannelStats {
+  std::size_t commands{0};    ///< Protocol lines sent to the simulator
+  std::size_t flushes{0};     ///< Times the write buffer was pushed out
+  std::size_t round_trips{0}; ///< Commands that blocked waiting for a reply
+};
+
+/**
+ * @brief Pipelined, buffered command channel to the simulator
+ *
+ * Fire-and-forget commands (colors, text, walls) are only appended to a
+ * write buffer. The buffer is pushed to the output stream in one write when
+ * a command that needs a reply is issued, so a burst of display updates
+ * costs a single flush instead of one flush per line.
+ *
+ * Replies are read into a fixed buffer and the write buffer keeps its
+ * capacity, so once warmed up the channel does not allocate.
+ *
+ * Several commands can also be sent at once with send() and their replies
+ * collected later with receive(), leaving the caller free to compute while
+ * they are in flight. start_reader() adds a thread that reads each reply
+ * as soon as it arrives, which tells when it actually came in.
+ *
+ * In binary mode (see binary_framing.hpp) commands are written as given,
+ * without a newline, and every reply is a single byte, returned whole.
+ */
+class CommandChannel {
+public:
+  /**
+   * @brief Construct a channel over a pair of streams
+   * @param in Stream the simulator replies are read from
+   * @param out Stream the commands are written to
+   */
+  CommandChannel(std::istream &in, std::ostream &out);
+
+  /**
+   * @brief Flushes any pending commands before the channel goes away
+   *
+   * With a reader thread, waits for the input stream to end.
+   */
+  ~CommandChannel();
+
+  CommandChannel(const CommandChannel &) = delete;
+  CommandChannel &operator=(const CommandChannel &) = delete;
+
+  /**
+   * @brief Queue a command that does not expect a reply
+   * @param line Command text without the trailing newline
+   */
+  void post(std::string_view line);
+
+  /**
+   * @brief Send a command and wait for its reply
+   *
+   * Everything queued before @p line is flushed together with it.
+   * @param line Command text without the trailing newline
+   * @return The first whitespace-delimited token of the reply, valid until
+   * the next request; empty if the stream ended
+   */
+  std::string_view request(std::string_view line);
+
+  /**
+   * @brief Queue a command whose reply is read along with the next request
+   *
+   * The command adds no round-trip of its own. Only one such command may be
+   * outstanding.
+   * @param line Command text without the trailing newline
+   */
+  void defer_request(std::string_view line);
+
+  /**
+   * @brief Get the reply to the command passed to defer_request()
+   *
+   * If no request has carried the command yet, it is sent now and waited for.
+   * @return The first whitespace-delimited token of the reply, valid until
+   * the next deferred request
+   */
+  std::string_view take_deferred_reply();
+
+  /**
+   * @brief Queue a command whose reply is collected later by receive()
+   *
+   * Nothing is written until the next flush(), request() or receive().
+   * @param line Command text without the trailing newline
+   */
+  void send(std::string_view line);
+
+  /**
+   * @brief Wait for the reply to the oldest command passed to send()
+   *
+   * Flushes first if needed. A batch of sent commands costs one round-trip,
+   * however many replies it brings back.
+   * @return The first whitespace-delimited token of the reply, valid until
+   * the next request or receive
+   */
+  std::string_view receive();
+
+  /**
+   * @brief Check, without blocking, if the replies to the commands sent
+   * and deferred so far have come in
+   *
+   * Without a reader thread, any reply waiting in the input stream buffer
+   * counts as all of them.
+   * @return true if receive() would not have to wait
+   */
+  bool replies_arrived();
+
+  /**
+   * @brief Get the time the reply returned last reached the process
+   *
+   * Without a reader thread this is when the reply was read.
+   * @return Arrival time of the last reply
+   */
+  [[nodiscard]] std::chrono::steady_clock::time_point
+  get_reply_time() const noexcept {
+    return reply_time_;
+  }
+
+  /**
+   * @brief Get the whole reply line returned last
+   *
+   * request() and receive() return its first token only.
+   * @return The reply, valid until the next request or receive
+   */
+  [[nodiscard]] std::string_view get_last_reply() const noexcept {
+    return {reply_.data(), reply_size_};
+  }
+
+  /**
+   * @brief Switch between text lines and binary frames
+   *
+   * Must be called with no reply outstanding and before start_reader().
+   * @param binary true to send frames and read one-byte replies
+   */
+  void set_binary(bool binary) noexcept { binary_ = binary; }
+
+  /**
+   * @brief Check the framing in use
+   * @return true in binary mode
+   */
+  [[nodiscard]] bool is_binary() const noexcept { return binary_; }
+
+  /**
+   * @brief Read replies on a thread of their own from now on
+   *
+   * The input stream must not be read by anyone else, and must end before
+   * the channel is destroyed.
+   */
+  void start_reader();
+
+  /**
+   * @brief Push the write buffer to the output stream
+   */
+  void flush();
+
+  /**
+   * @brief Get the traffic counters accumulated so far
+   * @return Copy of the counters
+   */
+  [[nodiscard]] ChannelStats get_stats() const noexcept { return stats_; }
+
+  /**
+   * @brief Reset the traffic counters to zero
+   */
+  void reset_stats() noexcept { stats_ = ChannelStats{}; }
+
+private:
+  // Reply line as handed over by the reader thread
+  struct ArrivedReply {
+    std::array<char, 64> text{};
+    std::size_t size{0};
+    std::chrono::steady_clock::time_point time{};
+  };
+
+  // Reply as returned to the caller: its first token in text mode
+  [[nodiscard]] std::string_view first_token(std::string_view reply) const noexcept;
+  // Read the next reply into @p text; false once the input has ended
+  bool read_one(std::array<char, 64> &text, std::size_t &size);
+  // Read the next reply into reply_
+  void read_reply();
+  // Body of the reader thread
+  void read_replies();
+  // Read the reply of the deferred command into deferred_reply_
+  void read_deferred_reply();
+
+  std::istream &in_;
+  std::ostream &out_;
+  std::string write_buffer_;
+  bool binary_{false};
+  // Longest reply kept; the rest of a longer line is dropped
+  std::array<char, 64> reply_{};
+  std::size_t reply_size_{0};
+  bool deferred_pending_{false};
+  std::array<char, 64> deferred_reply_{};
+  std::size_t deferred_size_{0};
+  bool batch_waiting_{false};
+  // Replies to sent and deferred commands not read yet
+  std::size_t outstanding_{0};
+  std::chrono::steady_clock::time_point reply_time_{};
+  ChannelStats stats_;
+
+  // Replies read ahead by the reader thread, oldest at arrived_head_
+  std::thread reader_;
+  std::mutex arrived_mutex_;
+  std::condition_variable arrived_ready_;
+  std::array<ArrivedReply, 32> arrived_{};
+  std::size_t arrived_head_{0};
+  std::size_t arrived_count_{0};
+  bool input_ended_{false};
+}; // class CommandChannel
+
+} // namespace micro_mouse
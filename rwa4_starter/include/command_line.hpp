@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace micro_mouse {
+
+/**
+ * @brief One protocol line built in place, so sending a command never
+ * allocates
+ *
+ * Tokens are separated by single spaces. Text longer than the buffer is
+ * cut; mms shows only a few characters per cell anyway.
+ */
+class CommandLine {
+public:
+  /**
+   * @brief Start a line with the command name
+   * @param name Command name
+   */
+  explicit CommandLine(std::string_view name) noexcept { append(name); }
+
+  /**
+   * @brief Start a line with the command name and a cell
+   * @param name Command name
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  CommandLine(std::string_view name, int x, int y) noexcept : CommandLine{name} {
+    append(x);
+    append(y);
+  }
+
+  CommandLine &append(std::string_view token) noexcept {
+    if (size_ != 0) {
+      put(' ');
+    }
+    for (const char c : token) {
+      put(c);
+    }
+    return *this;
+  }
+
+  CommandLine &append(char c) noexcept { return append(std::string_view{&c, 1}); }
+
+  CommandLine &append(int value) noexcept {
+    char digits[12];
+    const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    return append(
+        std::string_view{digits, static_cast<std::size_t>(result.ptr - digits)});
+  }
+
+  /**
+   * @brief Get the line built so far
+   * @return The line, without a newline
+   */
+  [[nodiscard]] std::string_view view() const noexcept {
+    return {data_.data(), size_};
+  }
+
+private:
+  void put(char c) noexcept {
+    if (size_ < data_.size()) {
+      data_[size_++] = c;
+    }
+  }
+
+  std::array<char, 96> data_{};
+  std::size_t size_{0};
+}; // class CommandLine
+
+} // namespace micro_mouse
@@ -0,0 +1,16 @@
+#pragma once
+#include <ctime>
+
+namespace micro_mouse {
+
+/**
+ * @brief CPU time consumed so far by the calling thread
+ * @return Seconds of CPU time
+ */
+inline double thread_cpu_seconds() noexcept {
+  timespec now{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+} // namespace micro_mouse
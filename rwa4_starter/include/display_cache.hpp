@@ -0,0 +1,147 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "maze_backend.hpp"
+#include "stamped_array.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Counters of the display commands issued and actually sent
+ */
+struct DisplayStats {
+  std::size_t requested{0}; ///< Color and text commands issued by the caller
+  std::size_t sent{0};      ///< Commands forwarded to the backend
+};
+
+/**
+ * @brief Client-side shadow of the colors and texts shown by the simulator
+ *
+ * A color or text is only sent when it differs from what the cell already
+ * shows. With a frame interval set, updates are held back and at most one
+ * command per cell and per property is sent per frame, carrying the latest
+ * value; intermediate values never reach the simulator.
+ *
+ * The colors and texts are kept in StampedArrays, so clearing all of them
+ * only starts a new generation on the client side, next to the single
+ * command sent to the simulator.
+ */
+class DisplayCache {
+public:
+  /**
+   * @brief Track a maze of the given size, all cells blank
+   * @param width Number of columns
+   * @param height Number of rows
+   */
+  void resize(int width, int height);
+
+  /**
+   * @brief Check if the cache has been sized
+   * @return true once resize() has been called with a non-empty maze
+   */
+  [[nodiscard]] bool is_sized() const noexcept { return shown_color_.size() != 0; }
+
+  /**
+   * @brief Set the minimum time between two frames
+   * @param interval Zero sends every change right away
+   */
+  void set_interval(std::chrono::steady_clock::duration interval) noexcept {
+    interval_ = interval;
+  }
+
+  /**
+   * @brief Show a color in a cell unless it already shows it
+   * @param backend Backend to send to
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param color Color character identifier
+   */
+  void set_color(MazeBackend &backend, int x, int y, char color);
+
+  /**
+   * @brief Clear the color of a cell unless it has none
+   * @param backend Backend to send to
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  void clear_color(MazeBackend &backend, int x, int y);
+
+  /**
+   * @brief Clear every color with a single command, if any is shown
+   * @param backend Backend to send to
+   */
+  void clear_all_color(MazeBackend &backend);
+
+  /**
+   * @brief Show a text in a cell unless it already shows it
+   * @param backend Backend to send to
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param text Text to display
+   */
+  void set_text(MazeBackend &backend, int x, int y, const std::string &text);
+
+  /**
+   * @brief Clear the text of a cell unless it has none
+   * @param backend Backend to send to
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  void clear_text(MazeBackend &backend, int x, int y);
+
+  /**
+   * @brief Clear every text with a single command, if any is shown
+   * @param backend Backend to send to
+   */
+  void clear_all_text(MazeBackend &backend);
+
+  /**
+   * @brief Send the held-back updates if a frame is due
+   * @param backend Backend to send to
+   * @param force Send them even if the frame interval has not elapsed
+   */
+  void flush(MazeBackend &backend, bool force);
+
+  /**
+   * @brief Get the display counters
+   * @return Commands issued and sent so far
+   */
+  [[nodiscard]] const DisplayStats &get_stats() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief Reset the display counters to zero
+   */
+  void reset_stats() noexcept { stats_ = DisplayStats{}; }
+
+private:
+  // Index of (x, y), or -1 if the cell is not tracked
+  [[nodiscard]] int cell_index(int x, int y) const noexcept;
+  // Record a new wanted state for a cell and send it unless held back
+  void update(MazeBackend &backend, int cell);
+  // Send whatever differs between the wanted and shown state of a cell
+  void send_cell(MazeBackend &backend, int cell);
+
+  static constexpr char no_color{'\0'};
+
+  int width_{0};
+  int height_{0};
+  StampedArray<char> shown_color_;
+  StampedArray<char> wanted_color_;
+  StampedArray<std::string> shown_text_;
+  StampedArray<std::string> wanted_text_;
+  // Cells showing a color or a text
+  std::size_t colors_shown_{0};
+  std::size_t texts_shown_{0};
+  std::vector<bool> dirty_;
+  std::vector<int> dirty_cells_;
+  std::chrono::steady_clock::duration interval_{};
+  std::chrono::steady_clock::time_point last_frame_{};
+  DisplayStats stats_;
+}; // class DisplayCache
+
+} // namespace micro_mouse
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Breadth-first distances computed one cell at a time with a queue
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every source cell (x, y)
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row;
+ * width * height for cells that cannot be reached
+ */
+void scalar_distances(const WallMap &map, const std::vector<std::uint64_t> &seeds,
+                      bool optimistic, std::vector<int> &distances);
+
+/**
+ * @brief Breadth-first distances computed a row at a time with bit masks
+ *
+ * The frontier is kept as one 64-bit mask per row. Each wave expands every
+ * row east and west with shifts and north and south with a plain AND
+ * against the open-edge masks of the WallMap, so a wave costs a few word
+ * operations per row regardless of the frontier size. Same results as
+ * scalar_distances().
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every source cell (x, y)
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row;
+ * width * height for cells that cannot be reached
+ */
+void wavefront_distances(const WallMap &map,
+                         const std::vector<std::uint64_t> &seeds,
+                         bool optimistic, std::vector<int> &distances);
+
+/**
+ * @brief Goal id of the cells no goal can reach
+ */
+inline constexpr std::uint8_t no_goal{0xFF};
+
+/**
+ * @brief Breadth-first distances from several goals at once, with the goal
+ * each cell is nearest to, computed one cell at a time with a queue
+ *
+ * Goal g is the g-th seed cell counting row by row from (0, 0), so the
+ * distance to the nearest goal and which goal that is come out of a single
+ * search. A cell at the same distance from several goals goes to the one
+ * with the lowest id.
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every goal cell (x, y), at most 255
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row;
+ * width * height for cells that cannot be reached
+ * @param nearest Receives width * height goal ids, row by row; no_goal for
+ * cells that cannot be reached
+ * @throw std::invalid_argument if there are more than 255 goals
+ */
+void scalar_nearest_goals(const WallMap &map,
+                          const std::vector<std::uint64_t> &seeds,
+                          bool optimistic, std::vector<int> &distances,
+                          std::vector<std::uint8_t> &nearest);
+
+/**
+ * @brief Same as scalar_nearest_goals(), a row at a time with bit masks
+ *
+ * The wave of wavefront_distances() is split into one frontier per goal.
+ * Each wave grows the frontiers in goal order and a cell goes to the first
+ * one reaching it, so a wave costs a few word operations per row and goal.
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every goal cell (x, y), at most 255
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row
+ * @param nearest Receives width * height goal ids, row by row
+ * @throw std::invalid_argument if there are more than 255 goals
+ */
+void wavefront_nearest_goals(const WallMap &map,
+                             const std::vector<std::uint64_t> &seeds,
+                             bool optimistic, std::vector<int> &distances,
+                             std::vector<std::uint8_t> &nearest);
+
+/**
+ * @brief Seeds covering the center goal cells
+ * @param width Number of columns
+ * @param height Number of rows
+ * @return One mask per row with the center cells set
+ */
+std::vector<std::uint64_t> center_seeds(int width, int height);
+
+/**
+ * @brief Distance kernel chosen at build time (RWA4_DISTANCE_KERNEL)
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every source cell (x, y)
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row
+ */
+inline void compute_distances(const WallMap &map,
+                              const std::vector<std::uint64_t> &seeds,
+                              bool optimistic, std::vector<int> &distances) {
+#ifdef RWA4_SCALAR_DISTANCES
+  scalar_distances(map, seeds, optimistic, distances);
+#else
+  wavefront_distances(map, seeds, optimistic, distances);
+#endif
+}
+
+/**
+ * @brief Nearest-goal kernel chosen at build time (RWA4_DISTANCE_KERNEL)
+ * @param map Wall knowledge
+ * @param seeds Bit x of seeds[y] set for every goal cell (x, y)
+ * @param optimistic Treat unknown edges as open
+ * @param distances Receives width * height distances, row by row
+ * @param nearest Receives width * height goal ids, row by row
+ */
+inline void compute_nearest_goals(const WallMap &map,
+                                  const std::vector<std::uint64_t> &seeds,
+                                  bool optimistic, std::vector<int> &distances,
+                                  std::vector<std::uint8_t> &nearest) {
+#ifdef RWA4_SCALAR_DISTANCES
+  scalar_nearest_goals(map, seeds, optimistic, distances, nearest);
+#else
+  wavefront_nearest_goals(map, seeds, optimistic, distances, nearest);
+#endif
+}
+
+} // namespace micro_mouse
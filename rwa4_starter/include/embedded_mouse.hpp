@@ -0,0 +1,142 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "maze_types.hpp"
+#include "serial_link.hpp"
+#include "static_wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief The mouse of the embedded build: its pose and its knowledge of a
+ * maze whose size is known at compile time
+ *
+ * Counterpart of Mouse with no heap behind it: the walls live in a
+ * StaticWallMap, the visited cells in a fixed array, and commands go
+ * straight to a SerialLink. Only sides never observed are asked to the
+ * simulator. There is no reset handling and no rule-based deduction.
+ * @tparam W Number of columns
+ * @tparam H Number of rows
+ */
+template <int W, int H> class EmbeddedMouse {
+public:
+  using Map = StaticWallMap<W, H>;
+
+  /**
+   * @brief Construct a mouse on the start cell
+   * @param link Link to the simulator; must outlive the mouse
+   */
+  explicit EmbeddedMouse(SerialLink &link) noexcept : link_{link} {
+    visited_[0] = true;
+  }
+
+  /**
+   * @brief Get the knowledge gathered so far
+   * @return The wall map
+   */
+  [[nodiscard]] const Map &get_map() const noexcept { return map_; }
+
+  /**
+   * @brief Check if a cell has been visited
+   * @param cell Index of the cell
+   * @return true if the mouse has been there
+   */
+  [[nodiscard]] bool is_visited(int cell) const noexcept {
+    return visited_[static_cast<std::size_t>(cell)];
+  }
+
+  /**
+   * @brief Count the visited cells
+   * @return Number of cells the mouse has been in
+   */
+  [[nodiscard]] int visited_count() const noexcept { return visited_count_; }
+
+  /**
+   * @brief Get the current column
+   * @return X coordinate of the mouse
+   */
+  [[nodiscard]] int get_x() const noexcept { return x_; }
+
+  /**
+   * @brief Get the current row
+   * @return Y coordinate of the mouse
+   */
+  [[nodiscard]] int get_y() const noexcept { return y_; }
+
+  /**
+   * @brief Get the current heading
+   * @return Heading of the mouse
+   */
+  [[nodiscard]] Direction get_heading() const noexcept { return heading_; }
+
+  /**
+   * @brief Check the left, front and right sides of the current cell,
+   * asking the simulator about those never observed
+   * @return Mask (see wall_bit()) of the sides found walled by this call
+   */
+  std::uint8_t sense() noexcept {
+    const int cell{Map::index(x_, y_)};
+    std::uint8_t discovered{0};
+    for (const auto d : {left_of(heading_), heading_, right_of(heading_)}) {
+      if (map_.is_known(cell, d)) {
+        continue;
+      }
+      const bool wall{d == heading_ ? link_.wall_front()
+                                    : (d == left_of(heading_) ? link_.wall_left()
+                                                              : link_.wall_right())};
+      map_.set_wall(x_, y_, d, wall);
+      if (wall) {
+        link_.set_wall(x_, y_, to_char(d));
+        discovered = static_cast<std::uint8_t>(discovered | wall_bit(d));
+      }
+    }
+    return discovered;
+  }
+
+  /**
+   * @brief Turn until facing @p d, using the shortest rotation
+   * @param d Absolute heading to face
+   */
+  void face(Direction d) noexcept {
+    if (d == right_of(heading_)) {
+      link_.turn_right();
+    } else if (d == left_of(heading_)) {
+      link_.turn_left();
+    } else if (d == opposite_of(heading_)) {
+      link_.turn_right();
+      link_.turn_right();
+    }
+    heading_ = d;
+  }
+
+  /**
+   * @brief Move one cell forward and update the pose
+   * @return false if the mouse crashed, in which case it did not move
+   */
+  bool move_forward() noexcept {
+    if (!link_.move_forward()) {
+      return false;
+    }
+    x_ += dx_of(heading_);
+    y_ += dy_of(heading_);
+    auto &visited = visited_[static_cast<std::size_t>(Map::index(x_, y_))];
+    if (!visited) {
+      visited = true;
+      ++visited_count_;
+    }
+    return true;
+  }
+
+private:
+  SerialLink &link_;
+  Map map_;
+  std::array<bool, W * H> visited_{};
+  int visited_count_{1};
+  int x_{0};
+  int y_{0};
+  Direction heading_{Direction::NORTH};
+}; // class EmbeddedMouse
+
+} // namespace micro_mouse
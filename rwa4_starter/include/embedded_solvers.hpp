@@ -0,0 +1,299 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "embedded_mouse.hpp"
+#include "maze_types.hpp"
+#include "move_choice.hpp"
+#include "static_bucket_queue.hpp"
+#include "static_flood_fill.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Outcome of an exploration of the embedded build
+ */
+struct EmbeddedRun {
+  bool reached_center{false}; ///< The exploration reached the center
+  int moves{0};               ///< Moves made by the exploration
+  int cells_explored{0};      ///< Cells visited
+};
+
+/**
+ * @brief Explore to the center with a solver policy of the embedded build
+ *
+ * The loop of explore_with(), over an EmbeddedMouse: on each cell the
+ * mouse senses its left, front and right sides, the policy picks the side
+ * to leave through, and the mouse turns and moves one cell. The policy
+ * provides void observe(const EmbeddedMouse &, std::uint8_t walls) and
+ * std::optional<Direction> next(const EmbeddedMouse &). Both the mouse and
+ * the policy are the caller's, so that they can live in static storage.
+ * @tparam Policy Solver policy
+ * @tparam W Number of columns
+ * @tparam H Number of rows
+ * @param mouse Mouse to drive, on its start pose
+ * @param policy Policy constructed for this exploration
+ * @param max_moves Give up after this many moves, never if 0
+ * @return Whether the center was reached, and in how many moves
+ */
+template <class Policy, int W, int H>
+EmbeddedRun explore_embedded(EmbeddedMouse<W, H> &mouse, Policy &policy,
+                             int max_moves) noexcept {
+  EmbeddedRun result;
+  while (max_moves == 0 || result.moves < max_moves) {
+    if (is_center_cell(mouse.get_x(), mouse.get_y(), W, H)) {
+      result.reached_center = true;
+      break;
+    }
+    policy.observe(mouse, mouse.sense());
+    const auto direction = policy.next(mouse);
+    if (!direction) {
+      SerialLink::log("No path to the center");
+      break;
+    }
+    mouse.face(*direction);
+    if (!mouse.move_forward()) {
+      break;
+    }
+    ++result.moves;
+  }
+  result.cells_explored = mouse.visited_count();
+  return result;
+}
+
+/**
+ * @brief FloodFillPolicy of the embedded build, over a StaticFloodFill
+ */
+template <int W, int H> class EmbeddedFloodFill {
+public:
+  void observe(const EmbeddedMouse<W, H> &mouse, std::uint8_t walls) noexcept {
+    for (const auto d :
+         {Direction::NORTH, Direction::EAST, Direction::SOUTH, Direction::WEST}) {
+      if (walls & wall_bit(d)) {
+        flood_.add_wall(mouse.get_x(), mouse.get_y(), d);
+      }
+    }
+  }
+
+  [[nodiscard]] std::optional<Direction>
+  next(const EmbeddedMouse<W, H> &mouse) const noexcept {
+    const int cell{StaticWallMap<W, H>::index(mouse.get_x(), mouse.get_y())};
+    const auto best =
+        choose_move(flood_, mouse.get_x(), mouse.get_y(), mouse.get_heading(),
+                    [&](Direction d) { return mouse.get_map().has_wall(cell, d); });
+    if (best.distance == flood_.unreachable()) {
+      return std::nullopt;
+    }
+    return best.direction;
+  }
+
+private:
+  StaticFloodFill<W, H> flood_;
+}; // class EmbeddedFloodFill
+
+/**
+ * @brief WallFollower of the embedded build
+ */
+template <int W, int H> class EmbeddedWallFollower {
+public:
+  void observe(const EmbeddedMouse<W, H> & /*mouse*/, std::uint8_t /*walls*/) noexcept {}
+
+  [[nodiscard]] std::optional<Direction>
+  next(const EmbeddedMouse<W, H> &mouse) const noexcept {
+    const int cell{StaticWallMap<W, H>::index(mouse.get_x(), mouse.get_y())};
+    const Direction heading{mouse.get_heading()};
+    for (const auto d :
+         {left_of(heading), heading, right_of(heading), opposite_of(heading)}) {
+      if (!mouse.get_map().has_wall(cell, d)) {
+        return d;
+      }
+    }
+    return std::nullopt;
+  }
+}; // class EmbeddedWallFollower
+
+/**
+ * @brief DfsBacktracking of the embedded build
+ *
+ * Each move forward enters a cell for the first time, so the path back to
+ * the start never holds more than W * H moves.
+ */
+template <int W, int H> class EmbeddedDfs {
+public:
+  void observe(const EmbeddedMouse<W, H> & /*mouse*/, std::uint8_t /*walls*/) noexcept {}
+
+  std::optional<Direction> next(const EmbeddedMouse<W, H> &mouse) noexcept {
+    const int x{mouse.get_x()};
+    const int y{mouse.get_y()};
+    const int cell{StaticWallMap<W, H>::index(x, y)};
+    const Direction heading{mouse.get_heading()};
+    std::optional<Direction> forward;
+    int best{0};
+    for (const auto d :
+         {heading, left_of(heading), right_of(heading), opposite_of(heading)}) {
+      if (mouse.get_map().has_wall(cell, d) ||
+          mouse.is_visited(StaticWallMap<W, H>::index(x + dx_of(d), y + dy_of(d)))) {
+        continue;
+      }
+      const int distance{crow_distance(x + dx_of(d), y + dy_of(d), W, H)};
+      if (!forward || distance < best) {
+        forward = d;
+        best = distance;
+      }
+    }
+    if (forward) {
+      path_[path_size_++] = *forward;
+      return forward;
+    }
+    if (path_size_ > 0) {
+      return opposite_of(path_[--path_size_]);
+    }
+    // Every cell reachable from the start has been searched
+    return std::nullopt;
+  }
+
+private:
+  std::array<Direction, W * H> path_{};
+  int path_size_{0};
+}; // class EmbeddedDfs
+
+/**
+ * @brief FrontierExplorer of the embedded build
+ *
+ * The frontier lives in a StaticBucketQueue keyed by the distance to the
+ * center of a StaticFloodFill. As the field keeps no log of the cells it
+ * changes, every frontier cell is re-keyed after a wall is found; the
+ * frontier is a small part of the maze, and keys that did not move cost a
+ * comparison.
+ */
+template <int W, int H> class EmbeddedFrontier {
+public:
+  using Map = StaticWallMap<W, H>;
+
+  void observe(const EmbeddedMouse<W, H> &mouse, std::uint8_t walls) noexcept {
+    const int cell{Map::index(mouse.get_x(), mouse.get_y())};
+    frontier_.erase(cell);
+    for (const auto d :
+         {Direction::NORTH, Direction::EAST, Direction::SOUTH, Direction::WEST}) {
+      if (walls & wall_bit(d)) {
+        flood_.add_wall(mouse.get_x(), mouse.get_y(), d);
+      }
+    }
+    for (int d{0}; d < 4; ++d) {
+      const int next{Map::neighbours[static_cast<std::size_t>(cell)]
+                                    [static_cast<std::size_t>(d)]};
+      if (is_open(mouse.get_map(), cell, d) && !mouse.is_visited(next)) {
+        frontier_.push(next, distance(next));
+      }
+    }
+    if (walls != 0) {
+      // The queue cannot be re-keyed while walked, so the cells go through
+      // the work list of next() first
+      int count{0};
+      for (int queued{frontier_.first()}; queued >= 0; queued = frontier_.next(queued)) {
+        work_[static_cast<std::size_t>(count++)] = static_cast<std::int16_t>(queued);
+      }
+      for (int i{0}; i < count; ++i) {
+        const int queued{work_[static_cast<std::size_t>(i)]};
+        frontier_.push(queued, distance(queued));
+      }
+    }
+  }
+
+  std::optional<Direction> next(const EmbeddedMouse<W, H> &mouse) noexcept {
+    const auto &map = mouse.get_map();
+    constexpr int unreachable{W * H};
+    const int start{Map::index(mouse.get_x(), mouse.get_y())};
+    // Moves from the mouse over known-open edges
+    travel_.fill(static_cast<std::int16_t>(unreachable));
+    travel_[static_cast<std::size_t>(start)] = 0;
+    work_[0] = static_cast<std::int16_t>(start);
+    int tail{1};
+    for (int head{0}; head < tail; ++head) {
+      const int cell{work_[static_cast<std::size_t>(head)]};
+      for (int d{0}; d < 4; ++d) {
+        const int next{Map::neighbours[static_cast<std::size_t>(cell)]
+                                      [static_cast<std::size_t>(d)]};
+        if (is_open(map, cell, d) && travel(next) == unreachable) {
+          travel_[static_cast<std::size_t>(next)] =
+              static_cast<std::int16_t>(travel(cell) + 1);
+          work_[static_cast<std::size_t>(tail++)] = static_cast<std::int16_t>(next);
+        }
+      }
+    }
+
+    // Same search as FrontierExplorer::next()
+    int target{-1};
+    int best{unreachable * 2};
+    for (int cell{frontier_.first()}; cell >= 0; cell = frontier_.next(cell)) {
+      const int to_center{frontier_.key(cell)};
+      if (to_center == unreachable || to_center + 1 >= best) {
+        break;
+      }
+      if (travel(cell) != unreachable && travel(cell) + to_center < best) {
+        best = travel(cell) + to_center;
+        target = cell;
+      }
+    }
+    if (target < 0) {
+      return std::nullopt;
+    }
+    // Walk back to the cell next to the mouse, keeping straight where the
+    // route allows; the side it was entered through is the move
+    int cell{target};
+    Direction back{Direction::NORTH};
+    while (travel(cell) > 1) {
+      for (const auto d : {back, left_of(back), right_of(back), opposite_of(back)}) {
+        const int next{Map::neighbours[static_cast<std::size_t>(cell)]
+                                      [static_cast<std::size_t>(d)]};
+        if (is_open(map, cell, static_cast<int>(d)) && travel(next) == travel(cell) - 1) {
+          cell = next;
+          back = d;
+          break;
+        }
+      }
+    }
+    for (int d{0}; d < 4; ++d) {
+      if (Map::neighbours[static_cast<std::size_t>(start)][static_cast<std::size_t>(d)] ==
+          cell) {
+        return static_cast<Direction>(d);
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  static bool is_open(const Map &map, int cell, int d) noexcept {
+    return map.is_known(cell, static_cast<Direction>(d)) &&
+           !map.has_wall(cell, static_cast<Direction>(d));
+  }
+
+  [[nodiscard]] int distance(int cell) const noexcept {
+    return flood_.distance(cell % W, cell / W);
+  }
+
+  [[nodiscard]] int travel(int cell) const noexcept {
+    return travel_[static_cast<std::size_t>(cell)];
+  }
+
+  StaticFloodFill<W, H> flood_;
+  StaticBucketQueue<W * H, W * H> frontier_;
+  std::array<std::int16_t, W * H> travel_{};
+  std::array<std::int16_t, W * H> work_{}; // BFS queue, or cells to re-key
+}; // class EmbeddedFrontier
+
+/**
+ * @brief Static memory an exploration of the embedded build needs
+ * @tparam Policy Solver policy of the embedded build
+ * @tparam W Number of columns
+ * @tparam H Number of rows
+ * @return Bytes of the mouse and of the policy state
+ */
+template <template <int, int> class Policy, int W, int H>
+constexpr std::size_t embedded_footprint() noexcept {
+  return sizeof(EmbeddedMouse<W, H>) + sizeof(Policy<W, H>);
+}
+
+} // namespace micro_mouse
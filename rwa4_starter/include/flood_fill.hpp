@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "maze_types.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Work done by FloodFill to repair its distances
+ */
+struct RepairStats {
+  std::size_t walls{0};         ///< Walls reported with add_wall()
+  std::size_t cells_touched{0}; ///< Cells re-examined by those repairs
+};
+
+/**
+ * @brief Distance-to-center field kept consistent as walls are discovered
+ *
+ * Unknown edges are assumed open. When a wall is found, only the cells
+ * whose distance is no longer one more than their best open neighbour are
+ * updated, instead of re-flooding the whole maze (modified flood fill).
+ */
+class FloodFill {
+public:
+  /**
+   * @brief Construct the field and flood it from the center
+   * @param map Wall knowledge to follow; must outlive the field
+   */
+  explicit FloodFill(const WallMap &map);
+
+  /**
+   * @brief Flood the whole maze again from the center
+   */
+  void recompute();
+
+  /**
+   * @brief Repair the field after a wall was recorded in the map
+   * @param x X coordinate of a cell next to the wall
+   * @param y Y coordinate of a cell next to the wall
+   * @param d Side of (x, y) the wall is on
+   * @return Number of cells examined by the repair
+   */
+  std::size_t add_wall(int x, int y, Direction d);
+
+  /**
+   * @brief Get the distance of a cell to the center
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @return Number of moves, unreachable() if there is no path
+   */
+  [[nodiscard]] int distance(int x, int y) const {
+    return distances_[static_cast<std::size_t>(y * map_.width() + x)];
+  }
+
+  /**
+   * @brief Distance given to cells with no path to the center
+   * @return A value larger than any real distance
+   */
+  [[nodiscard]] int unreachable() const noexcept {
+    return map_.width() * map_.height();
+  }
+
+  /**
+   * @brief Log the cells whose distance the repairs change
+   *
+   * recompute() is not logged.
+   * @param track true to log the changes from now on
+   */
+  void track_changes(bool track) noexcept { track_changes_ = track; }
+
+  /**
+   * @brief Get the cells changed since the last clear_changes()
+   * @return Cell indices (y * width + x), in the order they changed; a cell
+   * may appear more than once
+   */
+  [[nodiscard]] const std::vector<int> &get_changes() const noexcept {
+    return changes_;
+  }
+
+  /**
+   * @brief Empty the log of changed cells
+   */
+  void clear_changes() noexcept { changes_.clear(); }
+
+  /**
+   * @brief Get the repair counters
+   * @return Walls reported and cells examined so far
+   */
+  [[nodiscard]] const RepairStats &get_stats() const noexcept {
+    return stats_;
+  }
+
+private:
+  // Distance (x, y) should have given its neighbours
+  [[nodiscard]] int expected_distance(int x, int y) const;
+
+  const WallMap &map_;
+  std::vector<int> distances_;
+  std::vector<int> pending_;
+  bool track_changes_{false};
+  std::vector<int> changes_;
+  RepairStats stats_;
+}; // class FloodFill
+
+} // namespace micro_mouse
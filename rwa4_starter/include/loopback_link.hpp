@@ -0,0 +1,92 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+#include "protocol_server.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief In-memory pipe between a StreamBackend and a ProtocolServer
+ *
+ * Whatever the client writes is handed to the server, line by line or
+ * frame by frame, when the client flushes; the replies become readable from client_in(). Both
+ * ends run on the calling thread, so runs are deterministic.
+ */
+class LoopbackLink {
+public:
+  /**
+   * @brief Connect a new client to @p server
+   * @param server Simulator side; must outlive the link
+   */
+  explicit LoopbackLink(ProtocolServer &server);
+
+  LoopbackLink(const LoopbackLink &) = delete;
+  LoopbackLink &operator=(const LoopbackLink &) = delete;
+
+  /**
+   * @brief Stream the client reads replies from
+   * @return Input end of the link
+   */
+  std::istream &client_in() noexcept { return in_; }
+
+  /**
+   * @brief Stream the client writes commands to
+   * @return Output end of the link
+   */
+  std::ostream &client_out() noexcept { return out_; }
+
+  /**
+   * @brief CPU time spent in the server so far
+   * @return Seconds of CPU time
+   */
+  [[nodiscard]] double get_server_seconds() const noexcept {
+    return server_seconds_;
+  }
+
+private:
+  // Client to server: collects the written text until the next flush
+  class RequestBuffer : public std::streambuf {
+  public:
+    explicit RequestBuffer(LoopbackLink &link) : link_{link} {}
+    std::string pending;
+
+  protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    LoopbackLink &link_;
+  };
+
+  // Server to client: replies not yet read by the client
+  class ReplyBuffer : public std::streambuf {
+  public:
+    explicit ReplyBuffer(LoopbackLink &link) : link_{link} {}
+    void append(std::string_view text);
+
+  protected:
+    int_type underflow() override;
+
+  private:
+    LoopbackLink &link_;
+    std::string data_;
+  };
+
+  // Hand every complete pending line or frame to the server
+  void serve();
+
+  ProtocolServer &server_;
+  RequestBuffer requests_;
+  ReplyBuffer replies_;
+  std::istream in_;
+  std::ostream out_;
+  std::string reply_;
+  double server_seconds_{0.0};
+}; // class LoopbackLink
+
+} // namespace micro_mouse
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace micro_mouse {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The contents are read straight from the page cache; nothing is copied
+ * into the process. The mapping lasts as long as the object.
+ */
+class MappedFile {
+public:
+  /**
+   * @brief Map a file
+   * @param path File to map
+   * @throw std::runtime_error if the file cannot be opened or mapped
+   */
+  explicit MappedFile(const std::string &path);
+
+  /**
+   * @brief Unmap the file
+   */
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Get the contents
+   * @return The bytes of the file, valid while the object lives
+   */
+  [[nodiscard]] std::string_view text() const noexcept {
+    return {static_cast<const char *>(data_), size_};
+  }
+
+private:
+  void *data_{nullptr};
+  std::size_t size_{0};
+}; // class MappedFile
+
+} // namespace micro_mouse
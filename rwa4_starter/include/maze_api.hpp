@@ -1,6 +1,12 @@
 #pragma once
+#include <chrono>
 #include <string>
 
+#include "command_channel.hpp"
+#include "display_cache.hpp"
+#include "maze_backend.hpp"
+#include "maze_session.hpp"
+
 namespace micro_mouse {
 
 /**
@@ -8,17 +14,25 @@ namespace micro_mouse {
  *
  * This class provides methods to navigate through a maze, query maze
  * properties, manipulate walls, set colors and text, and handle reset events.
+ * Commands are forwarded to a process-wide MazeSession over the mms
+ * simulator on stdin/stdout, unless another backend is installed with
+ * set_backend(). Code that runs several mice at once uses one MazeSession
+ * per mouse instead.
  */
 class MazeControlAPI {
 public:
   /**
    * @brief Get the width of the maze
+   *
+   * Only the first call reaches the simulator.
    * @return The width of the maze in cells
    */
   static int get_maze_width();
 
   /**
    * @brief Get the height of the maze
+   *
+   * Only the first call reaches the simulator.
    * @return The height of the maze in cells
    */
   static int get_maze_height();
@@ -133,6 +147,67 @@ public:
    */
   static void log(std::string_view text);
 
+  /**
+   * @brief Route all commands to another backend
+   *
+   * The backend is not owned and must outlive its use.
+   * @param backend Backend to use, nullptr to restore the stdin/stdout one
+   */
+  static void set_backend(MazeBackend *backend);
+
+  /**
+   * @brief Record every command and reply from now on to a trace file
+   *
+   * The backend in use is wrapped in a RecordingBackend; a ReplayBackend
+   * can play the trace back later. Call before the first command, as the
+   * session starts over.
+   * @param path Trace file to create
+   * @throw std::runtime_error if the file cannot be created
+   */
+  static void record_to(const std::string &path);
+
+  /**
+   * @brief Get the session the static functions forward to
+   * @return The process-wide session
+   */
+  static MazeSession &get_session();
+
+  /**
+   * @brief Send every queued command to the simulator now
+   *
+   * Commands that do not expect a reply (walls, colors, text) are buffered
+   * and only sent along with the next query or motion command. Display
+   * updates held back by the frame interval are sent as well.
+   */
+  static void flush();
+
+  /**
+   * @brief Cap the rate at which colors and texts are sent
+   *
+   * Updates are then collected and sent at most once per interval, with
+   * the next command that reaches the simulator; several updates of the
+   * same cell within a frame cost a single command.
+   * @param interval Minimum time between frames, zero to send right away
+   */
+  static void set_display_interval(std::chrono::milliseconds interval);
+
+  /**
+   * @brief Get the number of display commands issued and actually sent
+   * @return Counters of the display cache
+   */
+  static DisplayStats get_display_stats();
+
+  /**
+   * @brief Get the number of commands, flushes and round-trips so far
+   * @return Traffic counters of the simulator channel
+   */
+  static ChannelStats get_channel_stats();
+
+  /**
+   * @brief Reset the traffic and display counters
+   */
+  static void reset_channel_stats();
+
 }; // class MazeControlAPI
 
 } // namespace maze
\ No newline at end of file
@@ -0,0 +1,224 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+#include "command_channel.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief One step of the mouse: turn, move, then sense the new cell
+ */
+struct StepRequest {
+  int turns{0};            ///< Quarter turns first, clockwise if positive
+  int distance{1};         ///< Cells to move
+  bool sense_left{false};  ///< Query the left side after the move
+  bool sense_front{false}; ///< Query the front side after the move
+  bool sense_right{false}; ///< Query the right side after the move
+};
+
+/**
+ * @brief Replies to a StepRequest
+ */
+struct StepReply {
+  bool moved{false};      ///< The move succeeded
+  bool wall_left{false};  ///< Wall on the left, if it was queried
+  bool wall_front{false}; ///< Wall in front, if it was queried
+  bool wall_right{false}; ///< Wall on the right, if it was queried
+  std::chrono::steady_clock::time_point sent{};    ///< Commands sent
+  std::chrono::steady_clock::time_point arrived{}; ///< Last reply came in
+};
+
+/**
+ * @brief Abstract endpoint answering the commands of MazeControlAPI
+ *
+ * The default backend talks to the mms simulator over stdin/stdout. Other
+ * backends (e.g., the in-process MazeSimulator) answer the same commands
+ * without leaving the process.
+ */
+class MazeBackend {
+public:
+  virtual ~MazeBackend() = default;
+
+  /**
+   * @brief Get the width of the maze
+   * @return The width of the maze in cells
+   */
+  virtual int maze_width() = 0;
+
+  /**
+   * @brief Get the height of the maze
+   * @return The height of the maze in cells
+   */
+  virtual int maze_height() = 0;
+
+  /**
+   * @brief Check for a wall in front of the mouse
+   * @return true if there is a wall in front, false otherwise
+   */
+  virtual bool wall_front() = 0;
+
+  /**
+   * @brief Check for a wall on the right of the mouse
+   * @return true if there is a wall to the right, false otherwise
+   */
+  virtual bool wall_right() = 0;
+
+  /**
+   * @brief Check for a wall on the left of the mouse
+   * @return true if there is a wall to the left, false otherwise
+   */
+  virtual bool wall_left() = 0;
+
+  /**
+   * @brief Move the mouse forward
+   * @param distance Number of cells to move forward
+   * @return false if the mouse crashed into a wall, true otherwise
+   */
+  virtual bool move_forward(int distance) = 0;
+
+  /**
+   * @brief Turn the mouse a quarter turn clockwise
+   */
+  virtual void turn_right() = 0;
+
+  /**
+   * @brief Turn the mouse a quarter turn counter-clockwise
+   */
+  virtual void turn_left() = 0;
+
+  /**
+   * @brief Display a wall
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param direction Side of the cell ('n', 'e', 's', 'w')
+   */
+  virtual void set_wall(int x, int y, char direction) = 0;
+
+  /**
+   * @brief Remove a displayed wall
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param direction Side of the cell ('n', 'e', 's', 'w')
+   */
+  virtual void clear_wall(int x, int y, char direction) = 0;
+
+  /**
+   * @brief Set the color of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param color Color character identifier
+   */
+  virtual void set_color(int x, int y, char color) = 0;
+
+  /**
+   * @brief Clear the color of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  virtual void clear_color(int x, int y) = 0;
+
+  /**
+   * @brief Clear the color of every cell
+   */
+  virtual void clear_all_color() = 0;
+
+  /**
+   * @brief Set the text of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param text Text to display
+   */
+  virtual void set_text(int x, int y, const std::string &text) = 0;
+
+  /**
+   * @brief Clear the text of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  virtual void clear_text(int x, int y) = 0;
+
+  /**
+   * @brief Clear the text of every cell
+   */
+  virtual void clear_all_text() = 0;
+
+  /**
+   * @brief Check if the maze was reset
+   * @return true if the maze was reset, false otherwise
+   */
+  virtual bool was_reset() = 0;
+
+  /**
+   * @brief Queue a reset check to travel with the next command that waits
+   * for a reply
+   *
+   * The answer describes the state before that command runs. Only one check
+   * may be queued at a time.
+   */
+  virtual void queue_was_reset() = 0;
+
+  /**
+   * @brief Get the answer to the queued reset check
+   *
+   * Costs a round-trip of its own only if no command carried the check.
+   * @return true if the maze was reset
+   */
+  virtual bool take_was_reset() = 0;
+
+  /**
+   * @brief Acknowledge that the reset has been handled
+   */
+  virtual void ack_reset() = 0;
+
+  /**
+   * @brief Start a step; its replies are collected by finish_step()
+   *
+   * No other command may be issued in between. By default nothing is sent
+   * before finish_step(), which runs the commands one by one.
+   * @param step Motions and wall queries of the step
+   */
+  virtual void start_step(const StepRequest &step) { pending_step_ = step; }
+
+  /**
+   * @brief Wait for the replies to the step started last
+   * @return Outcome of the move and the walls sensed
+   */
+  virtual StepReply finish_step();
+
+  /**
+   * @brief Check, without blocking, if the step started last is answered
+   * @return true if finish_step() would not wait for the simulator
+   */
+  virtual bool step_answered() { return true; }
+
+  /**
+   * @brief Check if a started step runs while the caller goes on
+   *
+   * Only then is it worth computing something between start_step() and
+   * finish_step().
+   * @return true if start_step() sends the step right away
+   */
+  [[nodiscard]] virtual bool overlaps_steps() const { return false; }
+
+  /**
+   * @brief Send every queued command now
+   */
+  virtual void flush() = 0;
+
+  /**
+   * @brief Get the traffic counters of this backend
+   * @return Commands, flushes and round-trips so far
+   */
+  [[nodiscard]] virtual ChannelStats get_stats() const = 0;
+
+  /**
+   * @brief Reset the traffic counters of this backend
+   */
+  virtual void reset_stats() = 0;
+
+protected:
+  StepRequest pending_step_; ///< Step passed to start_step()
+}; // class MazeBackend
+
+} // namespace micro_mouse
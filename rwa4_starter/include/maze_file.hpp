@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "maze_types.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Ground-truth walls of a maze loaded from a file
+ *
+ * Walls are stored as one mask per cell (see wall_bit()), cells indexed
+ * row by row from the south-west corner.
+ */
+struct MazeLayout {
+  int width{0};                    ///< Number of columns
+  int height{0};                   ///< Number of rows
+  std::vector<std::uint8_t> walls; ///< Wall mask of each cell
+
+  /**
+   * @brief Check for a wall on one side of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @return true if the side is walled, false otherwise
+   */
+  [[nodiscard]] bool has_wall(int x, int y, Direction d) const {
+    return (walls[static_cast<std::size_t>(y * width + x)] & wall_bit(d)) != 0;
+  }
+};
+
+/**
+ * @brief Parse a maze in the mms ASCII map format
+ *
+ * Posts may be any character other than '-', '|' and space; the cell pitch
+ * is taken from the distance between the first two posts of the top line.
+ * @param in Stream holding the map, north row first
+ * @return Parsed maze
+ * @throw std::invalid_argument if the map is malformed
+ */
+MazeLayout parse_map_maze(std::istream &in);
+
+/**
+ * @brief Parse a maze in the mms num format (one "x y n e s w" per line)
+ * @param in Stream holding the maze
+ * @return Parsed maze
+ * @throw std::invalid_argument if a line is malformed or a coordinate is
+ * 64 or more
+ */
+MazeLayout parse_num_maze(std::istream &in);
+
+/**
+ * @brief Parse a maze held in memory straight into a fully known wall map
+ *
+ * Accepts both formats, told apart by the first character as in
+ * load_maze_file(), with the same checks as parse_map_maze() and
+ * parse_num_maze(). The text is scanned once without copying any line:
+ * the walls of each grid line are gathered into a row mask, and the masks
+ * are written a word at a time into the bit layout of the WallMap.
+ * @param text Contents of a .num or ASCII map file
+ * @return Map with every edge known and every cell visited, as from
+ * make_wall_map()
+ * @throw std::invalid_argument if the text is malformed
+ */
+WallMap parse_wall_map(std::string_view text);
+
+/**
+ * @brief Load a maze file straight into a fully known wall map
+ *
+ * The file is memory-mapped and handed to parse_wall_map().
+ * @param path Path to a .num or ASCII map file
+ * @return Map with every edge known and every cell visited
+ * @throw std::runtime_error if the file cannot be opened
+ * @throw std::invalid_argument if the file is malformed
+ */
+WallMap load_wall_map(const std::string &path);
+
+/**
+ * @brief Load a maze file, choosing the parser from its contents
+ *
+ * Goes through load_wall_map(), then make_layout().
+ * @param path Path to a .num or ASCII map file
+ * @return Parsed maze
+ * @throw std::runtime_error if the file cannot be opened
+ * @throw std::invalid_argument if the file is malformed
+ */
+MazeLayout load_maze_file(const std::string &path);
+
+/**
+ * @brief Build a fully known wall map from a loaded maze
+ * @param layout Ground-truth walls
+ * @return Map with every edge known
+ */
+WallMap make_wall_map(const MazeLayout &layout);
+
+/**
+ * @brief Build the per-cell walls of a fully known wall map
+ * @param map Map with every edge known
+ * @return Walls of every cell
+ */
+MazeLayout make_layout(const WallMap &map);
+
+} // namespace micro_mouse
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Wall map learned in an earlier run, with the key of its maze
+ */
+struct LearnedMaze {
+  std::uint64_t key; ///< MazeFingerprint hash of the maze
+  WallMap map;       ///< Walls, known edges and visited cells
+};
+
+/**
+ * @brief Save a learned map to a binary file
+ *
+ * The file is a 32-byte header (magic, version, dimensions, key, word
+ * counts) followed by the raw words of the walls, known edges and visited
+ * cells in host byte order. It is written next to @p path and renamed over
+ * it, so a reader never sees a partial file.
+ * @param path File to write
+ * @param key Fingerprint of the maze
+ * @param map Map to save
+ * @throw std::runtime_error if the file cannot be written
+ */
+void save_learned_maze(const std::string &path, std::uint64_t key,
+                       const WallMap &map);
+
+/**
+ * @brief Load a map saved by save_learned_maze()
+ *
+ * The file is memory-mapped and its words copied straight into the map.
+ * @param path File to read
+ * @param width Expected number of columns
+ * @param height Expected number of rows
+ * @return The map, or nothing if the file is missing, malformed or for a
+ * maze of another size
+ */
+std::optional<LearnedMaze> load_learned_maze(const std::string &path, int width,
+                                             int height);
+
+} // namespace micro_mouse
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "maze_types.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief One side of one cell
+ */
+struct Edge {
+  int x;       ///< X coordinate of the cell
+  int y;       ///< Y coordinate of the cell
+  Direction d; ///< Side of the cell
+};
+
+/**
+ * @brief An edge deduced by MazeRules rather than sensed
+ */
+struct InferredEdge {
+  Edge edge; ///< The edge
+  bool wall; ///< true if it must be walled, false if it must be open
+};
+
+/**
+ * @brief Counters of the edges deduced by MazeRules, by rule
+ */
+struct InferenceStats {
+  std::size_t pegs{0};      ///< Last free edge of a peg that needs a wall
+  std::size_t center{0};    ///< Hollow center and its single entrance
+  std::size_t start{0};     ///< Three walls around the start cell
+  std::size_t dead_ends{0}; ///< Open side of a cell walled on three sides
+
+  /**
+   * @brief Count every deduced edge
+   * @return Edges deduced by all rules
+   */
+  [[nodiscard]] std::size_t total() const noexcept {
+    return pegs + center + start + dead_ends;
+  }
+};
+
+/**
+ * @brief Deduces unseen edges from the rules official mazes follow
+ *
+ * Official Micromouse mazes are fully enclosed, have no inaccessible cell,
+ * exactly three walls around the start cell, a hollow center with a single
+ * entrance, and a wall attached to every peg but the center one. Each edge
+ * that becomes known is checked against these rules:
+ *
+ * - a peg whose other three edges are open must be walled on the fourth;
+ * - a cell walled on three sides is a dead end, entered from the fourth;
+ * - once the entrance of the center is found, every other side of the
+ *   center is walled, and the last side not walled is the entrance;
+ * - the edges inside the center and the north side of the start cell are
+ *   open, the east side of the start cell is walled.
+ *
+ * Deduced edges are recorded in the map and checked in turn. Mazes that
+ * break the rules (e.g., with pegs standing free) get wrong deductions, so
+ * the rules are only applied on request.
+ */
+class MazeRules {
+public:
+  /**
+   * @brief Construct the rules of a maze
+   * @param width Number of columns
+   * @param height Number of rows
+   */
+  MazeRules(int width, int height);
+
+  /**
+   * @brief Record the edges known before anything is sensed
+   *
+   * Applies the start and hollow center rules.
+   * @param map Map to complete
+   */
+  void seed(WallMap &map);
+
+  /**
+   * @brief Deduce what follows from an edge that just became known
+   * @param map Map holding the edge; deductions are recorded in it
+   * @param edge The edge
+   */
+  void propagate(WallMap &map, const Edge &edge);
+
+  /**
+   * @brief Get the edges deduced since clear_inferred()
+   * @return Deduced edges, in the order they were found
+   */
+  [[nodiscard]] const std::vector<InferredEdge> &get_inferred() const noexcept {
+    return inferred_;
+  }
+
+  /**
+   * @brief Forget the edges returned by get_inferred()
+   */
+  void clear_inferred() noexcept { inferred_.clear(); }
+
+  /**
+   * @brief Get the deduction counters
+   * @return Edges deduced so far, by rule
+   */
+  [[nodiscard]] const InferenceStats &get_stats() const noexcept {
+    return stats_;
+  }
+
+private:
+  // Record a deduction if the edge is still unknown
+  void infer(WallMap &map, const Edge &edge, bool wall, std::size_t &counter);
+  // Rules about the pegs at the ends of an edge and the cells on its sides
+  void check_peg(WallMap &map, int px, int py);
+  void check_cell(WallMap &map, int x, int y);
+  void check_center(WallMap &map);
+  [[nodiscard]] bool in_center(int x, int y) const noexcept {
+    return is_center_cell(x, y, width_, height_);
+  }
+
+  int width_;
+  int height_;
+  // Sides of the center cells facing the rest of the maze
+  std::vector<Edge> entrances_;
+  std::vector<Edge> work_;
+  std::vector<InferredEdge> inferred_;
+  InferenceStats stats_;
+}; // class MazeRules
+
+} // namespace micro_mouse
@@ -0,0 +1,303 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "command_channel.hpp"
+#include "display_cache.hpp"
+#include "maze_backend.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief When a session checks for a press of the reset button
+ *
+ * A check is due after @c every_motions motion commands or once
+ * @c interval has elapsed since the last one, whichever comes first. With
+ * both at zero the session never checks.
+ */
+struct ResetPolicy {
+  int every_motions{0};                  ///< Motions between checks, 0 to ignore
+  std::chrono::milliseconds interval{0}; ///< Time between checks, 0 to ignore
+  bool piggyback{true};                  ///< Send the check with the motion
+};
+
+/**
+ * @brief Counters of the reset checks made by a session
+ */
+struct ResetStats {
+  std::size_t checks{0};      ///< wasReset queries sent
+  std::size_t piggybacked{0}; ///< Checks that did not cost a round-trip
+  std::size_t resets{0};      ///< Resets detected and acknowledged
+};
+
+/**
+ * @brief Connection of one mouse to one maze
+ *
+ * A session forwards the commands of a mouse to its own MazeBackend and owns
+ * the display cache and the maze dimensions learned from it. Sessions share
+ * no state, so several mice can run concurrently, one session per thread.
+ * Colors and texts go through a DisplayCache, so repainting a cell with
+ * what it already shows costs nothing.
+ *
+ * Motion commands can also watch the reset button (see ResetPolicy). A
+ * detected reset is acknowledged right away, which puts the mouse back on
+ * the start cell, and all colors and texts but the markers (see
+ * set_marker()) are cleared through the display cache; the walls shown
+ * stay, as the mouse keeps its map. The owner of the pose notices the reset
+ * through get_reset_stats().
+ */
+class MazeSession {
+public:
+  /**
+   * @brief Construct a session over a backend
+   * @param backend Backend to talk to; not owned and must outlive the session
+   */
+  explicit MazeSession(MazeBackend &backend) : backend_{&backend} {}
+
+  /**
+   * @brief Get the width of the maze
+   *
+   * Only the first call reaches the simulator.
+   * @return The width of the maze in cells
+   */
+  int get_maze_width();
+
+  /**
+   * @brief Get the height of the maze
+   *
+   * Only the first call reaches the simulator.
+   * @return The height of the maze in cells
+   */
+  int get_maze_height();
+
+  /**
+   * @brief Check if there is a wall in front of the current position
+   * @return true if there is a wall in front, false otherwise
+   */
+  bool has_wall_front();
+
+  /**
+   * @brief Check if there is a wall to the right of the current position
+   * @return true if there is a wall to the right, false otherwise
+   */
+  bool has_wall_right();
+
+  /**
+   * @brief Check if there is a wall to the left of the current position
+   * @return true if there is a wall to the left, false otherwise
+   */
+  bool has_wall_left();
+
+  /**
+   * @brief Move forward in the maze
+   *
+   * When a reset check is due, the check is made with this command and a
+   * detected reset is acknowledged.
+   * @param distance Number of cells to move forward (default: 1)
+   */
+  void move_forward(int distance = 1);
+
+  /**
+   * @brief Turn right (clockwise) in the maze
+   */
+  void turn_right();
+
+  /**
+   * @brief Turn left (counter-clockwise) in the maze
+   */
+  void turn_left();
+
+  /**
+   * @brief Start turning, moving and sensing in one exchange
+   *
+   * Counts as one motion per turn and move for the reset policy; a due
+   * check travels with the step. finish_step() must come before any other
+   * command.
+   * @param step Motions and wall queries of the step
+   */
+  void start_step(const StepRequest &step);
+
+  /**
+   * @brief Wait for the outcome of the step started last
+   *
+   * A reset detected with the step is acknowledged, as for move_forward().
+   * @return Walls sensed, and when the step was sent and answered
+   * @throw std::runtime_error if the mouse crashed into a wall
+   */
+  StepReply finish_step();
+
+  /**
+   * @brief Check, without blocking, if the step started last is answered
+   * @return true if finish_step() would not wait for the simulator
+   */
+  bool step_answered() { return backend_->step_answered(); }
+
+  /**
+   * @brief Check if the simulator works on a step while the mouse computes
+   * @return true if start_step() sends the step right away
+   */
+  [[nodiscard]] bool overlaps_steps() const { return backend_->overlaps_steps(); }
+
+  /**
+   * @brief Set a wall at the specified position and direction
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param direction Direction of the wall ('n', 's', 'e', 'w' for north,
+   * south, east, west)
+   */
+  void set_wall(int x, int y, char direction);
+
+  /**
+   * @brief Clear a wall at the specified position and direction
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param direction Direction of the wall ('n', 's', 'e', 'w' for north,
+   * south, east, west)
+   */
+  void clear_wall(int x, int y, char direction);
+
+  /**
+   * @brief Set the color of a cell in the maze
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param color Color character identifier
+   */
+  void set_color(int x, int y, char color);
+
+  /**
+   * @brief Clear the color of a cell in the maze
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  void clear_color(int x, int y);
+
+  /**
+   * @brief Clear all colors from the entire maze
+   */
+  void clear_all_color();
+
+  /**
+   * @brief Set text at the specified cell in the maze
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param text Text string to display at the cell
+   */
+  void set_text(int x, int y, const std::string &text);
+
+  /**
+   * @brief Clear text from the specified cell in the maze
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  void clear_text(int x, int y);
+
+  /**
+   * @brief Clear all text from the entire maze
+   */
+  void clear_all_text();
+
+  /**
+   * @brief Paint a cell that keeps its color and text across resets
+   *
+   * Markers, such as the start and the center cells, are painted again
+   * after the wipe that follows a reset.
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param color Color character identifier
+   * @param text Text string to display at the cell
+   */
+  void set_marker(int x, int y, char color, const std::string &text);
+
+  /**
+   * @brief Check if the maze was reset
+   * @return true if the maze was reset, false otherwise
+   */
+  bool was_reset();
+
+  /**
+   * @brief Acknowledge that the reset has been handled
+   */
+  void ack_reset();
+
+  /**
+   * @brief Send every queued command to the simulator now
+   *
+   * Commands that do not expect a reply (walls, colors, text) are buffered
+   * and only sent along with the next query or motion command. Display
+   * updates held back by the frame interval are sent as well.
+   */
+  void flush();
+
+  /**
+   * @brief Cap the rate at which colors and texts are sent
+   *
+   * Updates are then collected and sent at most once per interval, with
+   * the next command that reaches the simulator; several updates of the
+   * same cell within a frame cost a single command.
+   * @param interval Minimum time between frames, zero to send right away
+   */
+  void set_display_interval(std::chrono::milliseconds interval);
+
+  /**
+   * @brief Get the number of display commands issued and actually sent
+   * @return Counters of the display cache
+   */
+  DisplayStats get_display_stats();
+
+  /**
+   * @brief Get the number of commands, flushes and round-trips so far
+   * @return Traffic counters of the simulator channel
+   */
+  ChannelStats get_channel_stats();
+
+  /**
+   * @brief Reset the traffic and display counters
+   */
+  void reset_channel_stats();
+
+  /**
+   * @brief Choose when motion commands check for a reset
+   * @param policy Check interval, never by default
+   */
+  void set_reset_policy(const ResetPolicy &policy);
+
+  /**
+   * @brief Get the reset check counters
+   * @return Checks made and resets detected so far
+   */
+  [[nodiscard]] const ResetStats &get_reset_stats() const noexcept {
+    return reset_stats_;
+  }
+
+private:
+  // Backend for a command that talks to the simulator; display updates held
+  // back for the current frame go out first if the frame is due.
+  MazeBackend &command_backend();
+  DisplayCache &display();
+  // Start a reset check if one is due; returns true if it was started
+  bool begin_reset_check();
+  // Finish the check started for the motion that just ran
+  void end_reset_check();
+
+  struct Marker {
+    int x;
+    int y;
+    char color;
+    std::string text;
+  };
+
+  MazeBackend *backend_;
+  DisplayCache display_;
+  int width_{0};
+  int height_{0};
+  ResetPolicy reset_policy_;
+  ResetStats reset_stats_;
+  int motions_since_check_{0};
+  bool step_check_{false};
+  std::chrono::steady_clock::time_point last_check_{};
+  std::vector<Marker> markers_;
+}; // class MazeSession
+
+} // namespace micro_mouse
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+#include <utility>
+
+#include "maze_backend.hpp"
+#include "maze_file.hpp"
+#include "maze_types.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Counters of the mouse motion in a MazeSimulator run
+ */
+struct SimulatorStats {
+  int moves{0};              ///< Cells travelled
+  int turns{0};              ///< Quarter turns
+  int crashes{0};            ///< Moves refused because of a wall
+  bool goal_reached{false};  ///< The mouse entered a center cell
+};
+
+/**
+ * @brief In-process, headless stand-in for the mms simulator
+ *
+ * Answers sensing and motion commands from a maze loaded in memory. Display
+ * commands are accepted and dropped. The mouse starts in (0, 0) facing
+ * north, as in mms.
+ */
+class MazeSimulator : public MazeBackend {
+public:
+  /**
+   * @brief Construct a simulator over a known maze
+   * @param layout Ground-truth walls
+   */
+  explicit MazeSimulator(MazeLayout layout) : layout_{std::move(layout)} {}
+
+  /**
+   * @brief Put the mouse back on the start cell and clear the counters
+   */
+  void restart();
+
+  /**
+   * @brief Simulate a press of the reset button
+   *
+   * The mouse stays where it is until the reset is acknowledged.
+   */
+  void request_reset() noexcept { reset_requested_ = true; }
+
+  /**
+   * @brief Press the reset button once the mouse has travelled some cells
+   * @param moves Cells travelled in the current run before the press
+   */
+  void schedule_reset(int moves) noexcept { reset_at_move_ = moves; }
+
+  /**
+   * @brief Get the motion counters of the current run
+   * @return Moves, turns and crashes so far
+   */
+  [[nodiscard]] const SimulatorStats &get_run_stats() const noexcept {
+    return run_stats_;
+  }
+
+  /**
+   * @brief Get the ground-truth maze
+   * @return The maze being simulated
+   */
+  [[nodiscard]] const MazeLayout &get_layout() const noexcept {
+    return layout_;
+  }
+
+  int maze_width() override;
+  int maze_height() override;
+  bool wall_front() override;
+  bool wall_right() override;
+  bool wall_left() override;
+  bool move_forward(int distance) override;
+  void turn_right() override;
+  void turn_left() override;
+  void set_wall(int x, int y, char direction) override;
+  void clear_wall(int x, int y, char direction) override;
+  void set_color(int x, int y, char color) override;
+  void clear_color(int x, int y) override;
+  void clear_all_color() override;
+  void set_text(int x, int y, const std::string &text) override;
+  void clear_text(int x, int y) override;
+  void clear_all_text() override;
+  bool was_reset() override;
+  void ack_reset() override;
+  void queue_was_reset() override;
+  bool take_was_reset() override { return queued_reset_; }
+  void flush() override {}
+  [[nodiscard]] ChannelStats get_stats() const override { return stats_; }
+  void reset_stats() override { stats_ = ChannelStats{}; }
+
+private:
+  // Answer a wall query relative to the current heading
+  bool sense(Direction d);
+  // Count a command that does not expect a reply
+  void post() noexcept { ++stats_.commands; }
+
+  MazeLayout layout_;
+  int x_{0};
+  int y_{0};
+  Direction heading_{Direction::NORTH};
+  bool reset_requested_{false};
+  bool queued_reset_{false};
+  int reset_at_move_{-1};
+  SimulatorStats run_stats_;
+  ChannelStats stats_;
+}; // class MazeSimulator
+
+} // namespace micro_mouse
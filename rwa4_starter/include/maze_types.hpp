@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace micro_mouse {
+
+/**
+ * @enum Direction
+ * @brief Absolute heading in the maze, (0, 0) being the south-west corner
+ */
+enum class Direction : std::uint8_t {
+  NORTH, // +y
+  EAST,  // +x
+  SOUTH, // -y
+  WEST   // -x
+};
+
+/**
+ * @brief Heading after a quarter turn clockwise
+ * @param d Current heading
+ * @return Heading on the right of @p d
+ */
+constexpr Direction right_of(Direction d) noexcept {
+  return static_cast<Direction>((static_cast<int>(d) + 1) % 4);
+}
+
+/**
+ * @brief Heading after a quarter turn counter-clockwise
+ * @param d Current heading
+ * @return Heading on the left of @p d
+ */
+constexpr Direction left_of(Direction d) noexcept {
+  return static_cast<Direction>((static_cast<int>(d) + 3) % 4);
+}
+
+/**
+ * @brief Heading after a half turn
+ * @param d Current heading
+ * @return Heading opposite to @p d
+ */
+constexpr Direction opposite_of(Direction d) noexcept {
+  return static_cast<Direction>((static_cast<int>(d) + 2) % 4);
+}
+
+/**
+ * @brief Step along x when moving one cell towards @p d
+ * @param d Heading
+ * @return -1, 0 or 1
+ */
+constexpr int dx_of(Direction d) noexcept {
+  return d == Direction::EAST ? 1 : (d == Direction::WEST ? -1 : 0);
+}
+
+/**
+ * @brief Step along y when moving one cell towards @p d
+ * @param d Heading
+ * @return -1, 0 or 1
+ */
+constexpr int dy_of(Direction d) noexcept {
+  return d == Direction::NORTH ? 1 : (d == Direction::SOUTH ? -1 : 0);
+}
+
+/**
+ * @brief Direction character used by the simulator protocol
+ * @param d Heading
+ * @return One of 'n', 'e', 's', 'w'
+ */
+constexpr char to_char(Direction d) noexcept {
+  constexpr char names[]{'n', 'e', 's', 'w'};
+  return names[static_cast<int>(d)];
+}
+
+/**
+ * @brief Bit of @p d in a per-cell wall mask (N=1, E=2, S=4, W=8)
+ * @param d Side of the cell
+ * @return Mask with the single bit of @p d set
+ */
+constexpr std::uint8_t wall_bit(Direction d) noexcept {
+  return static_cast<std::uint8_t>(1U << static_cast<unsigned>(d));
+}
+
+/**
+ * @brief Check whether a cell belongs to the goal area in the maze center
+ *
+ * The goal is the 2x2 block in the middle of the maze (a single row or
+ * column of it collapses when the dimension is odd).
+ * @param x X coordinate of the cell
+ * @param y Y coordinate of the cell
+ * @param width Number of columns of the maze
+ * @param height Number of rows of the maze
+ * @return true if (x, y) is a goal cell
+ */
+constexpr bool is_center_cell(int x, int y, int width, int height) noexcept {
+  return (x == (width - 1) / 2 || x == width / 2) &&
+         (y == (height - 1) / 2 || y == height / 2);
+}
+
+/**
+ * @brief Moves from a cell to the goal area with no walls in the way
+ * @param x X coordinate of the cell
+ * @param y Y coordinate of the cell
+ * @param width Number of columns of the maze
+ * @param height Number of rows of the maze
+ * @return Manhattan distance to the nearest goal cell
+ */
+constexpr int crow_distance(int x, int y, int width, int height) noexcept {
+  const int dx{std::max({0, (width - 1) / 2 - x, x - width / 2})};
+  const int dy{std::max({0, (height - 1) / 2 - y, y - height / 2})};
+  return dx + dy;
+}
+
+} // namespace micro_mouse
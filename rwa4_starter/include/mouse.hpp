@@ -0,0 +1,238 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "maze_backend.hpp"
+#include "maze_types.hpp"
+#include "wall_map.hpp"
+#include "wall_sensor.hpp"
+
+namespace micro_mouse {
+
+class MazeSession;
+
+/**
+ * @brief The mouse: its pose and its knowledge of the maze
+ *
+ * Wall queries go through a WallSensor, which only asks the simulator
+ * about edges that have never been observed. Every motion command keeps
+ * the pose in sync with the simulator; when the session reports a reset,
+ * the pose goes back to the start cell and the map is kept.
+ */
+class Mouse {
+public:
+  /**
+   * @brief Construct a mouse on the start cell, sizing the map from the
+   * simulator behind MazeControlAPI
+   */
+  Mouse();
+
+  /**
+   * @brief Construct a mouse on the start cell, sizing the map from the
+   * simulator of a session
+   * @param session Session the commands of the mouse go through
+   */
+  explicit Mouse(MazeSession &session);
+
+  /**
+   * @brief Construct a mouse on the start cell of a maze of known size
+   * @param session Session the commands of the mouse go through
+   * @param width Number of columns
+   * @param height Number of rows
+   */
+  Mouse(MazeSession &session, int width, int height);
+
+  /**
+   * @brief Get the session the mouse talks through
+   * @return The session
+   */
+  [[nodiscard]] MazeSession &get_session() const noexcept { return session_; }
+
+  /**
+   * @brief Get the knowledge gathered so far
+   * @return The wall map
+   */
+  [[nodiscard]] const WallMap &get_map() const noexcept {
+    return sensor_.get_map();
+  }
+
+  /**
+   * @brief Get the wall query counters
+   * @return Queries sent to the simulator and answered locally
+   */
+  [[nodiscard]] const SensingStats &get_sensing_stats() const noexcept {
+    return sensor_.get_stats();
+  }
+
+  /**
+   * @brief Deduce unseen edges from the rules of official mazes
+   *
+   * See MazeRules; only for mazes that follow them.
+   */
+  void use_maze_rules() { sensor_.use_maze_rules(); }
+
+  /**
+   * @brief Get the edges deduced since the last clear_inferred()
+   * @return Deduced edges, already recorded in the map
+   */
+  [[nodiscard]] const std::vector<InferredEdge> &get_inferred() const noexcept {
+    return sensor_.get_inferred();
+  }
+
+  /**
+   * @brief Forget the edges returned by get_inferred()
+   */
+  void clear_inferred() noexcept { sensor_.clear_inferred(); }
+
+  /**
+   * @brief Get the deduction counters
+   * @return Edges deduced so far, by rule
+   */
+  [[nodiscard]] InferenceStats get_inference_stats() const noexcept {
+    return sensor_.get_inference_stats();
+  }
+
+  /**
+   * @brief Get the hash of the first walls sensed
+   * @return The fingerprint of the maze
+   */
+  [[nodiscard]] const MazeFingerprint &get_fingerprint() const noexcept {
+    return sensor_.get_fingerprint();
+  }
+
+  /**
+   * @brief Replace what the mouse knows with a map learned earlier
+   *
+   * Known edges are then answered without asking the simulator.
+   * @param map Map of the same maze
+   */
+  void learn(const WallMap &map);
+
+  /**
+   * @brief Get the number of resets the mouse has gone through
+   * @return Resets seen since the mouse was constructed
+   */
+  [[nodiscard]] std::size_t get_reset_count() const noexcept {
+    return resets_seen_;
+  }
+
+  /**
+   * @brief Get the current column
+   * @return X coordinate of the mouse
+   */
+  [[nodiscard]] int get_x() const noexcept { return x_; }
+
+  /**
+   * @brief Get the current row
+   * @return Y coordinate of the mouse
+   */
+  [[nodiscard]] int get_y() const noexcept { return y_; }
+
+  /**
+   * @brief Get the current heading
+   * @return Heading of the mouse
+   */
+  [[nodiscard]] Direction get_heading() const noexcept { return heading_; }
+
+  /**
+   * @brief Check for a wall on one side of the current cell
+   *
+   * Unknown sides are sensed (and displayed) first; the side behind the
+   * mouse is known from the cell the mouse came from.
+   * @param d Absolute side of the cell
+   * @return true if there is a wall
+   */
+  bool has_wall(Direction d);
+
+  /**
+   * @brief Check for a wall in front of the mouse
+   * @return true if there is a wall
+   */
+  bool has_wall_front() { return has_wall(heading_); }
+
+  /**
+   * @brief Check for a wall on the left of the mouse
+   * @return true if there is a wall
+   */
+  bool has_wall_left() { return has_wall(left_of(heading_)); }
+
+  /**
+   * @brief Check for a wall on the right of the mouse
+   * @return true if there is a wall
+   */
+  bool has_wall_right() { return has_wall(right_of(heading_)); }
+
+  /**
+   * @brief Check the left, front and right sides of the current cell
+   * @return Mask (see wall_bit()) of the sides found walled by this call
+   */
+  std::uint8_t sense();
+
+  /**
+   * @brief Move forward and update the pose
+   * @param distance Number of cells
+   */
+  void move_forward(int distance = 1);
+
+  /**
+   * @brief Turn a quarter turn clockwise
+   */
+  void turn_right();
+
+  /**
+   * @brief Turn a quarter turn counter-clockwise
+   */
+  void turn_left();
+
+  /**
+   * @brief Turn until facing @p d, using the shortest rotation
+   * @param d Absolute heading to face
+   * @return false if a reset sent the mouse back to the start pose on the
+   * way, in which case it stops turning there
+   */
+  bool face(Direction d);
+
+  /**
+   * @brief Start facing @p d and moving one cell, sensing the cell ahead in
+   * the same exchange
+   *
+   * The unknown left, front and right sides of the cell ahead are queried
+   * along with the motions. Nothing else may be sent to the simulator
+   * before finish_step().
+   * @param d Absolute heading to move towards
+   * @param sense false if the cell ahead needs no sensing
+   * @return Mask (see wall_bit()) of the sides being sensed
+   */
+  std::uint8_t start_step(Direction d, bool sense = true);
+
+  /**
+   * @brief Complete the step started last and update the pose
+   * @return Mask of the sides found walled, as sense() would return
+   */
+  std::uint8_t finish_step();
+
+  /**
+   * @brief Get the replies to the last step
+   * @return Walls sensed, and when the step was sent and answered
+   */
+  [[nodiscard]] const StepReply &get_last_step() const noexcept {
+    return last_step_;
+  }
+
+private:
+  // Go back to the start pose if the session acknowledged a reset
+  void follow_reset();
+
+  MazeSession &session_;
+  WallSensor sensor_;
+  int x_{0};
+  int y_{0};
+  Direction heading_{Direction::NORTH};
+  std::size_t resets_seen_{0};
+  Direction step_heading_{Direction::NORTH};
+  StepRequest step_;
+  StepReply last_step_;
+}; // class Mouse
+
+} // namespace micro_mouse
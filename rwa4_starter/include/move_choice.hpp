@@ -0,0 +1,40 @@
+#pragma once
+#include "maze_types.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Next move of the mouse: the open neighbour closest to a goal
+ */
+struct MoveChoice {
+  Direction direction; ///< Side of the cell to leave through
+  int distance;        ///< Distance of that neighbour; unreachable() of the
+                       ///< field if every side is closed
+};
+
+/**
+ * @brief Pick the open neighbour of (x, y) with the smallest distance,
+ * preferring to go straight, then left, then right
+ * @tparam Field Anything with distance(x, y) and unreachable()
+ * @tparam IsWalled Callable telling if a side of (x, y) is closed
+ * @param field Distances to the goal
+ * @param x X coordinate of the mouse
+ * @param y Y coordinate of the mouse
+ * @param heading Heading of the mouse
+ * @param walled Tells which sides may not be crossed
+ * @return The side to leave through and the distance behind it
+ */
+template <class Field, class IsWalled>
+MoveChoice choose_move(const Field &field, int x, int y, Direction heading,
+                       IsWalled walled) {
+  MoveChoice best{heading, field.unreachable()};
+  for (const auto d :
+       {heading, left_of(heading), right_of(heading), opposite_of(heading)}) {
+    if (!walled(d) && field.distance(x + dx_of(d), y + dy_of(d)) < best.distance) {
+      best = MoveChoice{d, field.distance(x + dx_of(d), y + dy_of(d))};
+    }
+  }
+  return best;
+}
+
+} // namespace micro_mouse
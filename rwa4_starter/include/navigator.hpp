@@ -0,0 +1,195 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "flood_fill.hpp"
+#include "maze_rules.hpp"
+#include "maze_session.hpp"
+#include "mouse.hpp"
+#include "speed_run.hpp"
+#include "wall_sensor.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief How much of the planning ran while a step was in flight
+ */
+struct OverlapStats {
+  std::size_t steps{0};         ///< Steps planned while in flight
+  double planning_seconds{0.0}; ///< Time spent planning the next move
+  double hidden_seconds{0.0};   ///< Part of it before the replies arrived
+
+  /**
+   * @brief Fraction of the planning hidden behind the simulator
+   * @return 0 to 1, 0 if nothing was planned
+   */
+  [[nodiscard]] double hidden_fraction() const noexcept {
+    return planning_seconds > 0.0 ? hidden_seconds / planning_seconds : 0.0;
+  }
+};
+
+/**
+ * @enum Exploration
+ * @brief When the exploration gives way to the speed run
+ */
+enum class Exploration : std::uint8_t {
+  TO_CENTER,     // As soon as the center is reached
+  PROVE_SHORTEST // Once no unknown edge can shorten the known route
+};
+
+/**
+ * @brief Bounds on the length of the shortest route from the start cell to
+ * the center, in cells
+ */
+struct PathBounds {
+  int optimistic{0};  ///< Shortest route with unknown edges open
+  int pessimistic{0}; ///< Shortest route over edges known to be open;
+                      ///< width * height if there is none yet
+  int goal_x{-1};     ///< Center cell that route ends in, -1 if none
+  int goal_y{-1};
+
+  /**
+   * @brief Check if the known route is a shortest one
+   * @return true if no unknown edge can shorten it
+   */
+  [[nodiscard]] bool met() const noexcept { return optimistic == pessimistic; }
+};
+
+/**
+ * @brief Bound the shortest route from the start cell to the center
+ *
+ * All center cells are flooded at once; which of them the known route
+ * ends in is read off the nearest-goal ids of the same pass.
+ * @param map Wall knowledge
+ * @return Lengths with unknown edges open and closed, and the goal cell
+ */
+PathBounds path_bounds(const WallMap &map);
+
+/**
+ * @brief Outcome of one navigation run
+ */
+struct RunResult {
+  bool reached_center{false}; ///< The exploration reached the center
+  int cells_explored{0};      ///< Cells visited during the exploration
+  int moves{0};               ///< Moves made by the exploration
+  RepairStats repair;         ///< Flood-fill repair counters
+  SensingStats sensing;       ///< Wall queries sent and avoided
+  SpeedRunPlan speed_run;     ///< Plan of the final speed run
+  bool warm_start{false};     ///< The speed run used a map saved earlier
+  OverlapStats overlap;       ///< Planning done while moving
+  InferenceStats inference;   ///< Edges deduced from the maze rules
+  PathBounds bounds;          ///< Route lengths when the exploration ended
+};
+
+/**
+ * @brief Exploration driving a mouse to the center
+ *
+ * Takes the mouse, whether to paint in the simulator and the move budget
+ * (unlimited if 0); see run_flood_fill() and solver_registry().
+ */
+using Explorer = RunResult (*)(Mouse &mouse, bool display, int max_moves);
+
+/**
+ * @brief Show the flood-fill distances in the simulator
+ * @tparam Field FloodFill or StaticFloodFill
+ * @param session Session to paint through
+ * @param flood Distance field to paint
+ * @param width Number of columns
+ * @param height Number of rows
+ */
+template <class Field>
+void paint_distances(MazeSession &session, const Field &flood, int width,
+                     int height) {
+  for (int y{0}; y < height; ++y) {
+    for (int x{0}; x < width; ++x) {
+      session.set_text(x, y, std::to_string(flood.distance(x, y)));
+    }
+  }
+}
+
+/**
+ * @brief Drive the mouse to the center with a flood-fill navigator
+ *
+ * Unknown walls are assumed open. At each cell the mouse senses its
+ * surroundings, repairs the distances around newly found walls and moves
+ * to the open neighbour closest to the center, preferring to go straight.
+ * Walls the mouse deduced (see Mouse::use_maze_rules()) are repaired
+ * around as if sensed.
+ * 16x16 and 32x32 mazes use a StaticFloodFill, other sizes a FloodFill.
+ *
+ * When the session overlaps steps (see MazeSession::overlaps_steps()) and
+ * the field is a StaticFloodFill, each move goes out together with the
+ * queries of the cell it leads to. While they are in flight the next move
+ * is planned for every possible answer, and the matching plan is picked
+ * when the replies arrive. The mouse takes the same path either way.
+ * @param mouse Mouse to drive
+ * @param display Paint the distances in the simulator
+ * @param max_moves Give up after this many moves, never if 0
+ * @return Whether the center was reached, the repair counters and the
+ * planning overlap
+ */
+RunResult run_flood_fill(Mouse &mouse, bool display, int max_moves);
+
+/**
+ * @brief Explore until the shortest route to the center is known
+ *
+ * Two distance fields to the center are kept: one with unknown edges open,
+ * which bounds the shortest route from below, and one over edges known to
+ * be open, which bounds it from above. While the bounds differ, every
+ * route as short as the lower bound crosses an unknown edge, and the mouse
+ * drives to the nearest cell of such a route that still has an unknown
+ * side. Once the bounds meet, the known route is a shortest one and
+ * exploring further cannot improve it, so the mouse stops, wherever it is.
+ * Cells off every shortest candidate route are never visited.
+ * @param mouse Mouse to drive
+ * @param display Paint the optimistic distances in the simulator
+ * @param max_moves Give up after this many moves, never if 0
+ * @return Whether a route to the center is known, and the final bounds
+ */
+RunResult run_two_bound(Mouse &mouse, bool display, int max_moves);
+
+/**
+ * @brief Explore to the center, return to the start and do a speed run
+ *
+ * The speed run follows the fastest route over edges known to be open,
+ * with straights merged into single multi-cell moves.
+ * @param session Session of the mouse; each concurrent run needs its own
+ * @param display Paint the distances in the simulator
+ * @param max_moves Move budget of the exploration, unlimited if 0
+ * @param maze_rules Deduce edges from the rules of official mazes (see
+ * MazeRules)
+ * @param exploration Explore with @p explorer until the center is reached,
+ * or with run_two_bound() until the shortest route is known
+ * @param explorer Exploration to the center
+ * @return Exploration counters and the speed-run plan
+ */
+RunResult run_mouse(MazeSession &session, bool display, int max_moves,
+                    bool maze_rules = false,
+                    Exploration exploration = Exploration::TO_CENTER,
+                    Explorer explorer = run_flood_fill);
+
+/**
+ * @brief Same as run_mouse(), reusing the map learned by an earlier run
+ *
+ * If @p memory_file holds a map of a maze of this size, the mouse explores
+ * only until its MazeFingerprint is complete. When the fingerprint and
+ * every wall seen so far match the saved map, the mouse adopts it and goes
+ * straight to the speed run. Otherwise it carries on exploring, and a run
+ * that reaches the center saves its map to @p memory_file.
+ * @param session Session of the mouse
+ * @param display Paint the distances in the simulator
+ * @param max_moves Move budget of the exploration, unlimited if 0
+ * @param memory_file File holding the learned map
+ * @param maze_rules Deduce edges from the rules of official mazes
+ * @param exploration When a run that found no usable memory stops exploring
+ * @param explorer Exploration to the center of such a run
+ * @return Exploration counters and the speed-run plan
+ */
+RunResult run_mouse_with_memory(MazeSession &session, bool display,
+                                int max_moves, const std::string &memory_file,
+                                bool maze_rules = false,
+                                Exploration exploration = Exploration::TO_CENTER,
+                                Explorer explorer = run_flood_fill);
+
+} // namespace micro_mouse
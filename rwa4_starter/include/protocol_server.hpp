@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "maze_backend.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Simulator side of the mms text protocol
+ *
+ * Parses command lines as mms would and answers them from a backend
+ * (typically a MazeSimulator), so a local stand-in can talk to a mouse
+ * exactly like mms does. Unknown commands are ignored, as in mms.
+ *
+ * The server can also offer the binary framing of binary_framing.hpp;
+ * once the client takes it up, commands go to handle_frame() instead.
+ */
+class ProtocolServer {
+public:
+  /**
+   * @brief Construct a server answering from @p backend
+   * @param backend Backend holding the maze; must outlive the server
+   */
+  explicit ProtocolServer(MazeBackend &backend) : backend_{backend} {}
+
+  /**
+   * @brief Handle one command line
+   * @param line Command without the trailing newline
+   * @param reply Receives the reply line without newline
+   * @return true if the command has a reply
+   */
+  bool handle(std::string_view line, std::string &reply);
+
+  /**
+   * @brief Handle one binary frame
+   *
+   * An unknown command byte is skipped.
+   * @param bytes Input not handled yet, starting with a frame
+   * @param reply Receives the reply byte; left empty if the command has none
+   * @return Number of bytes used, 0 if the frame is not complete yet
+   */
+  std::size_t handle_frame(std::string_view bytes, std::string &reply);
+
+  /**
+   * @brief Choose whether to offer the binary framing
+   *
+   * The offer follows the width in the mazeWidth reply, for mazes the
+   * frames can address.
+   * @param offer true to offer the binary framing
+   */
+  void set_binary_offer(bool offer) noexcept { offer_binary_ = offer; }
+
+  /**
+   * @brief Check the framing in use
+   * @return true once the client switched to binary frames
+   */
+  [[nodiscard]] bool is_binary() const noexcept { return binary_; }
+
+private:
+  MazeBackend &backend_;
+  bool offer_binary_{false};
+  bool binary_{false};
+  // Text of the last setText frame, kept to reuse its capacity
+  std::string text_;
+}; // class ProtocolServer
+
+} // namespace micro_mouse
@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "maze_backend.hpp"
+#include "trace_format.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Backend decorator that records a session to a trace file
+ *
+ * Every call is forwarded to another backend and written to the trace with
+ * its arguments, its reply and when it started and ended (see TraceRecord).
+ * A ReplayBackend plays the trace back without the simulator.
+ */
+class RecordingBackend : public MazeBackend {
+public:
+  /**
+   * @brief Start recording the calls made to @p inner
+   * @param inner Backend that answers the calls; must outlive the recorder
+   * @param path Trace file to create
+   * @throw std::runtime_error if the file cannot be created
+   */
+  RecordingBackend(MazeBackend &inner, const std::string &path);
+
+  int maze_width() override;
+  int maze_height() override;
+  bool wall_front() override;
+  bool wall_right() override;
+  bool wall_left() override;
+  bool move_forward(int distance) override;
+  void turn_right() override;
+  void turn_left() override;
+  void set_wall(int x, int y, char direction) override;
+  void clear_wall(int x, int y, char direction) override;
+  void set_color(int x, int y, char color) override;
+  void clear_color(int x, int y) override;
+  void clear_all_color() override;
+  void set_text(int x, int y, const std::string &text) override;
+  void clear_text(int x, int y) override;
+  void clear_all_text() override;
+  bool was_reset() override;
+  void ack_reset() override;
+  void queue_was_reset() override;
+  bool take_was_reset() override;
+  void flush() override;
+  [[nodiscard]] ChannelStats get_stats() const override {
+    return inner_.get_stats();
+  }
+  void reset_stats() override { inner_.reset_stats(); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // Append one record; start is when the call began
+  void record(Clock::time_point start, TraceOp op, int value = 0, int x = 0,
+              int y = 0, char argument = 0, std::string_view text = {});
+
+  MazeBackend &inner_;
+  std::ofstream out_;
+  Clock::time_point origin_;
+}; // class RecordingBackend
+
+} // namespace micro_mouse
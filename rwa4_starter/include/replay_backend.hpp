@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "maze_backend.hpp"
+#include "trace_format.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Backend answering from a trace written by a RecordingBackend
+ *
+ * Queries and motions get the replies recorded for them, in order, so a
+ * deterministic solver replays the recorded session exactly and as fast as
+ * it can run, without the simulator. Display calls are accepted and dropped;
+ * they get no reply and may legitimately differ (e.g., with a frame
+ * interval).
+ */
+class ReplayBackend : public MazeBackend {
+public:
+  /**
+   * @brief Load a trace
+   * @param path Trace file
+   * @throw std::runtime_error if the file cannot be read or is not a trace
+   */
+  explicit ReplayBackend(const std::string &path);
+
+  /**
+   * @brief Start replaying from the first call again
+   */
+  void rewind() noexcept;
+
+  /**
+   * @brief Check if every recorded query and motion was replayed
+   * @return true at the end of the trace
+   */
+  [[nodiscard]] bool finished() const noexcept {
+    return next_ == replies_.size();
+  }
+
+  /**
+   * @brief Get the length of the recorded session
+   * @return Seconds from the first to the end of the last recorded call
+   */
+  [[nodiscard]] double get_recorded_seconds() const noexcept {
+    return recorded_seconds_;
+  }
+
+  /**
+   * @brief Get the time the recorded session spent waiting on the simulator
+   * @return Sum of the recorded call durations, in seconds
+   */
+  [[nodiscard]] double get_recorded_wait_seconds() const noexcept {
+    return recorded_wait_seconds_;
+  }
+
+  int maze_width() override;
+  int maze_height() override;
+  bool wall_front() override;
+  bool wall_right() override;
+  bool wall_left() override;
+  bool move_forward(int distance) override;
+  void turn_right() override;
+  void turn_left() override;
+  void set_wall(int x, int y, char direction) override;
+  void clear_wall(int x, int y, char direction) override;
+  void set_color(int x, int y, char color) override;
+  void clear_color(int x, int y) override;
+  void clear_all_color() override;
+  void set_text(int x, int y, const std::string &text) override;
+  void clear_text(int x, int y) override;
+  void clear_all_text() override;
+  bool was_reset() override;
+  void ack_reset() override;
+  void queue_was_reset() override;
+  bool take_was_reset() override;
+  void flush() override {}
+  [[nodiscard]] ChannelStats get_stats() const override { return stats_; }
+  void reset_stats() override { stats_ = ChannelStats{}; }
+
+private:
+  // Consume the next recorded reply, which must be for @p op
+  const TraceRecord &expect(TraceOp op);
+  void post() noexcept { ++stats_.commands; }
+
+  std::vector<TraceRecord> replies_;
+  std::size_t next_{0};
+  double recorded_seconds_{0.0};
+  double recorded_wait_seconds_{0.0};
+  ChannelStats stats_;
+}; // class ReplayBackend
+
+} // namespace micro_mouse
@@ -0,0 +1,118 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace micro_mouse {
+
+/**
+ * @brief The mms protocol over a pair of file descriptors, without heap
+ * allocation
+ *
+ * The link of the embedded build (RWA4_EMBEDDED). Commands are formatted
+ * in a CommandLine and queued in a fixed output buffer; those without a
+ * reply (walls) only go out with the next command that has one.
+ * Replies are read through a fixed input buffer, and a reply longer than
+ * the reply buffer is cut. On a microcontroller the descriptors stand for
+ * the serial port bridged to the simulator.
+ */
+class SerialLink {
+public:
+  /**
+   * @brief Talk to the simulator over two descriptors
+   * @param in_fd Descriptor the replies are read from
+   * @param out_fd Descriptor the commands are written to
+   */
+  SerialLink(int in_fd, int out_fd) noexcept : in_fd_{in_fd}, out_fd_{out_fd} {}
+
+  /**
+   * @brief Ask the simulator for the width of the maze
+   * @return Number of columns, 0 if the simulator is gone
+   */
+  int maze_width() noexcept;
+
+  /**
+   * @brief Ask the simulator for the height of the maze
+   * @return Number of rows, 0 if the simulator is gone
+   */
+  int maze_height() noexcept;
+
+  /**
+   * @brief Check for a wall in front of the mouse
+   * @return true if there is a wall
+   */
+  bool wall_front() noexcept;
+
+  /**
+   * @brief Check for a wall on the right of the mouse
+   * @return true if there is a wall
+   */
+  bool wall_right() noexcept;
+
+  /**
+   * @brief Check for a wall on the left of the mouse
+   * @return true if there is a wall
+   */
+  bool wall_left() noexcept;
+
+  /**
+   * @brief Move one cell forward
+   * @return false if the mouse crashed into a wall
+   */
+  bool move_forward() noexcept;
+
+  /**
+   * @brief Turn a quarter turn clockwise
+   */
+  void turn_right() noexcept;
+
+  /**
+   * @brief Turn a quarter turn counter-clockwise
+   */
+  void turn_left() noexcept;
+
+  /**
+   * @brief Show a wall in the simulator
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param direction Side of the cell ('n', 'e', 's' or 'w')
+   */
+  void set_wall(int x, int y, char direction) noexcept;
+
+  /**
+   * @brief Send the queued commands now
+   */
+  void flush() noexcept;
+
+  /**
+   * @brief Check if the simulator is still there
+   * @return false once a read or a write has failed
+   */
+  [[nodiscard]] bool is_open() const noexcept { return open_; }
+
+  /**
+   * @brief Print a line in the simulator, through stderr
+   * @param text Line to print, without a newline
+   */
+  static void log(std::string_view text) noexcept;
+
+private:
+  // Queue a command and its newline
+  void post(std::string_view line) noexcept;
+
+  // Send a command with the queued ones and wait for its reply; empty if
+  // the simulator is gone
+  std::string_view request(std::string_view line) noexcept;
+
+  int in_fd_;
+  int out_fd_;
+  bool open_{true};
+  std::array<char, 256> output_{};
+  std::size_t output_size_{0};
+  std::array<char, 64> input_{};
+  std::size_t input_begin_{0};
+  std::size_t input_end_{0};
+  std::array<char, 32> reply_{};
+}; // class SerialLink
+
+} // namespace micro_mouse
@@ -0,0 +1,325 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "bucket_queue.hpp"
+#include "flood_fill.hpp"
+#include "maze_session.hpp"
+#include "maze_types.hpp"
+#include "mouse.hpp"
+#include "move_choice.hpp"
+#include "navigator.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Repair a flood-fill field around newly found walls
+ * @param field FloodFill or StaticFloodFill
+ * @param x X coordinate of the cell
+ * @param y Y coordinate of the cell
+ * @param walls Mask (see wall_bit()) of the walls around (x, y)
+ */
+template <class Field> void add_walls(Field &field, int x, int y, std::uint8_t walls) {
+  for (const auto d :
+       {Direction::NORTH, Direction::EAST, Direction::SOUTH, Direction::WEST}) {
+    if (walls & wall_bit(d)) {
+      field.add_wall(x, y, d);
+    }
+  }
+}
+
+/**
+ * @brief Repair a flood-fill field around the walls the mouse deduced
+ * since the last call
+ * @param field FloodFill or StaticFloodFill
+ * @param mouse Mouse whose deductions are consumed
+ * @return true if there were any walls
+ */
+template <class Field> bool add_inferred_walls(Field &field, Mouse &mouse) {
+  bool any{false};
+  for (const auto &inferred : mouse.get_inferred()) {
+    if (inferred.wall) {
+      field.add_wall(inferred.edge.x, inferred.edge.y, inferred.edge.d);
+      any = true;
+    }
+  }
+  mouse.clear_inferred();
+  return any;
+}
+
+/**
+ * @brief Distances computed by the distance kernel, seen through the
+ * interface of a FloodFill
+ */
+class DistanceView {
+public:
+  /**
+   * @brief View a distance vector
+   * @param distances width * height distances, row by row
+   * @param width Number of columns
+   * @param height Number of rows
+   */
+  DistanceView(const std::vector<int> &distances, int width, int height)
+      : distances_{distances}, width_{width}, unreachable_{width * height} {}
+
+  [[nodiscard]] int distance(int x, int y) const {
+    return distances_[static_cast<std::size_t>(y * width_ + x)];
+  }
+  [[nodiscard]] int unreachable() const noexcept { return unreachable_; }
+
+private:
+  const std::vector<int> &distances_;
+  int width_;
+  int unreachable_;
+}; // class DistanceView
+
+/**
+ * @brief Explore to the center with a solver policy
+ *
+ * The loop is the same for every solver: on each cell the mouse senses its
+ * left, front and right sides, the policy updates its state and picks the
+ * side to leave through, and the mouse turns and moves one cell. As the
+ * policy is a template parameter, its calls are inlined into the loop.
+ *
+ * A Policy provides:
+ * - a constructor taking the Mouse, on its start pose;
+ * - void observe(Mouse &mouse, std::uint8_t walls), given the mask (see
+ *   wall_bit()) of the walls just found around the mouse; deductions (see
+ *   Mouse::get_inferred()) are the policy's to consume;
+ * - std::optional<Direction> next(const Mouse &mouse), empty if the policy
+ *   sees no way to the center;
+ * - void paint(MazeSession &session), showing its state in the simulator;
+ * - void report(RunResult &result) const, filling in its counters.
+ * @tparam Policy Solver policy
+ * @param mouse Mouse to drive
+ * @param display Let the policy paint in the simulator
+ * @param max_moves Give up after this many moves, never if 0
+ * @return Whether the center was reached, and the policy counters
+ */
+template <class Policy>
+RunResult explore_with(Mouse &mouse, bool display, int max_moves) {
+  const auto &map = mouse.get_map();
+  Policy policy{mouse};
+  RunResult result;
+  int moves{0};
+  while (max_moves == 0 || moves < max_moves) {
+    if (is_center_cell(mouse.get_x(), mouse.get_y(), map.width(), map.height())) {
+      result.reached_center = true;
+      break;
+    }
+    policy.observe(mouse, mouse.sense());
+    if (display) {
+      policy.paint(mouse.get_session());
+    }
+    const auto direction = policy.next(mouse);
+    if (!direction) {
+      std::cerr << "No path to the center" << std::endl;
+      break;
+    }
+    if (!mouse.face(*direction)) {
+      // A reset took the mouse back to the start: look around from there
+      continue;
+    }
+    mouse.move_forward();
+    ++moves;
+  }
+  policy.report(result);
+  result.cells_explored = static_cast<int>(map.visited_count());
+  result.moves = moves;
+  return result;
+}
+
+/**
+ * @brief Flood fill: move to the open neighbour closest to the center,
+ * unknown walls assumed open
+ * @tparam Field FloodFill or StaticFloodFill
+ */
+template <class Field> class FloodFillPolicy {
+public:
+  /**
+   * @brief Flood the field from the map of the mouse, deductions included
+   * @param mouse Mouse to drive
+   */
+  explicit FloodFillPolicy(Mouse &mouse)
+      : map_{mouse.get_map()}, flood_{mouse.get_map()} {
+    mouse.clear_inferred();
+  }
+
+  void observe(Mouse &mouse, std::uint8_t walls) {
+    add_walls(flood_, mouse.get_x(), mouse.get_y(), walls);
+    add_inferred_walls(flood_, mouse);
+  }
+
+  [[nodiscard]] std::optional<Direction> next(const Mouse &mouse) const {
+    const int x{mouse.get_x()};
+    const int y{mouse.get_y()};
+    const auto best = choose_move(flood_, x, y, mouse.get_heading(),
+                                  [&](Direction d) { return map_.has_wall(x, y, d); });
+    if (best.distance == flood_.unreachable()) {
+      return std::nullopt;
+    }
+    return best.direction;
+  }
+
+  void paint(MazeSession &session) const {
+    paint_distances(session, flood_, map_.width(), map_.height());
+  }
+
+  void report(RunResult &result) const { result.repair = flood_.get_stats(); }
+
+private:
+  const WallMap &map_;
+  Field flood_;
+}; // class FloodFillPolicy
+
+/**
+ * @brief Left-hand wall follower: turn left if open, else go straight,
+ * else right, else back
+ *
+ * Needs no memory, but never reaches a center that is not connected to
+ * the outer wall, as in official mazes.
+ */
+class WallFollower {
+public:
+  explicit WallFollower(Mouse &mouse) : map_{mouse.get_map()} {}
+
+  void observe(Mouse &mouse, std::uint8_t /*walls*/) { mouse.clear_inferred(); }
+
+  [[nodiscard]] std::optional<Direction> next(const Mouse &mouse) const noexcept {
+    const Direction heading{mouse.get_heading()};
+    for (const auto d :
+         {left_of(heading), heading, right_of(heading), opposite_of(heading)}) {
+      if (!map_.has_wall(mouse.get_x(), mouse.get_y(), d)) {
+        return d;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void paint(MazeSession & /*session*/) const noexcept {}
+
+  void report(RunResult & /*result*/) const noexcept {}
+
+private:
+  const WallMap &map_;
+}; // class WallFollower
+
+/**
+ * @brief Depth-first search with backtracking
+ *
+ * The mouse enters an unvisited open neighbour if it has one, the one
+ * nearest to the center as the crow flies first, and otherwise walks back
+ * along the path it came by. Every reachable cell is entered at most once
+ * on the way forward. After a reset the mouse first walks the path again
+ * from the start cell.
+ */
+class DfsBacktracking {
+public:
+  explicit DfsBacktracking(Mouse &mouse)
+      : map_{mouse.get_map()}, resets_{mouse.get_reset_count()} {}
+
+  void observe(Mouse &mouse, std::uint8_t /*walls*/) { mouse.clear_inferred(); }
+
+  std::optional<Direction> next(const Mouse &mouse);
+
+  /// Colors the path back to the start
+  void paint(MazeSession &session);
+
+  void report(RunResult & /*result*/) const noexcept {}
+
+private:
+  const WallMap &map_;
+  // Moves from the start to the mouse, less those walked back
+  std::vector<Direction> path_;
+  // Moves of the path the mouse has made since the last reset
+  std::size_t replayed_{0};
+  // Resets of the mouse when the path was last followed
+  std::size_t resets_;
+  // Cell left by walking back, to uncolor
+  int left_x_{-1};
+  int left_y_{-1};
+}; // class DfsBacktracking
+
+/**
+ * @brief Frontier exploration: drive to the cheapest cell next to the part
+ * of the maze explored so far
+ *
+ * The frontier is made of the unvisited cells behind a side of a visited
+ * cell known to be open. A frontier cell costs the moves to get there over
+ * known-open edges plus its distance to the center with unknown edges
+ * open, and the mouse drives towards the cheapest one.
+ *
+ * The frontier lives in a BucketQueue keyed by the distance to the center,
+ * which a FloodFill keeps up to date. Both change as walls are sensed: a
+ * cell leaves the frontier when entered, its open neighbours come in, and
+ * only the frontier cells whose distance a new wall changed are re-keyed.
+ * The target is found by walking the queue in key order, stopping as soon
+ * as no further cell can beat the best one so far.
+ */
+class FrontierExplorer {
+public:
+  explicit FrontierExplorer(Mouse &mouse);
+
+  void observe(Mouse &mouse, std::uint8_t walls);
+
+  std::optional<Direction> next(const Mouse &mouse);
+
+  /// Shows the distances to the center
+  void paint(MazeSession &session) const {
+    paint_distances(session, flood_, map_.width(), map_.height());
+  }
+
+  void report(RunResult &result) const { result.repair = flood_.get_stats(); }
+
+  /**
+   * @brief Count the frontier cells
+   * @return Unvisited cells next to the explored part of the maze
+   */
+  [[nodiscard]] std::size_t frontier_size() const noexcept {
+    return frontier_.size();
+  }
+
+private:
+  // Queue the cell behind side d of (x, y) if (x, y) is visited, the side
+  // known open and the cell unvisited
+  void add_frontier(int x, int y, Direction d);
+
+  const WallMap &map_;
+  FloodFill flood_;
+  BucketQueue frontier_;
+  std::vector<std::uint64_t> seeds_;
+  std::vector<int> travel_;
+}; // class FrontierExplorer
+
+/**
+ * @brief Solver that can be picked by name
+ */
+struct SolverEntry {
+  std::string_view name; ///< Name on the command line
+  Explorer explore;      ///< Exploration to the center
+};
+
+/**
+ * @brief Get the solvers that can be picked by name
+ *
+ * Each is an instance of explore_with() compiled along with its policy,
+ * except flood-fill, which is run_flood_fill().
+ * @return The solvers, the default first
+ */
+const std::array<SolverEntry, 4> &solver_registry() noexcept;
+
+/**
+ * @brief Find a solver by name
+ * @param name Name of the solver
+ * @return Its exploration
+ * @throw std::invalid_argument if no solver has that name
+ */
+Explorer find_solver(std::string_view name);
+
+} // namespace micro_mouse
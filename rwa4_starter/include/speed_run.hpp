@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "maze_types.hpp"
+#include "mouse.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Time model of the mouse motion, in seconds
+ *
+ * A straight of n cells takes <tt>straight_overhead + n * cell_time</tt>:
+ * the overhead accounts for accelerating and braking, so one long straight
+ * is cheaper than several short ones.
+ */
+struct MotionCost {
+  double cell_time{0.2};         ///< Time per cell at cruising speed
+  double straight_overhead{0.3}; ///< Acceleration and braking per straight
+  double turn_time{0.4};         ///< Time of a quarter turn in place
+};
+
+/**
+ * @brief One command of a speed run
+ */
+struct Motion {
+  /**
+   * @enum Kind
+   * @brief Kind of command
+   */
+  enum class Kind : std::uint8_t {
+    FORWARD,    // move_forward(cells)
+    TURN_LEFT,  // turn_left()
+    TURN_RIGHT  // turn_right()
+  };
+  Kind kind{Kind::FORWARD};
+  int cells{0}; ///< Cells to travel, FORWARD only
+};
+
+/**
+ * @brief A planned speed run
+ */
+struct SpeedRunPlan {
+  bool reachable{false};          ///< A goal can be reached over known edges
+  std::vector<Motion> motions;    ///< Commands in execution order
+  double time{0.0};               ///< Estimated time with straights merged
+  double cell_by_cell_time{0.0};  ///< Estimated time moving one cell per
+                                  ///< command along the same route
+  int cells{0};                   ///< Cells travelled
+  int turns{0};                   ///< Quarter turns
+};
+
+/**
+ * @brief Plan the fastest route to a goal over known-open edges
+ *
+ * Dijkstra search over (cell, heading) states. From a state the mouse can
+ * turn a quarter turn either way or drive straight for any number of open
+ * cells, each priced with @p cost. Straights are therefore emitted already
+ * merged into single move_forward(n) commands.
+ * @param map Wall knowledge; only edges known to be open are used
+ * @param x Start column
+ * @param y Start row
+ * @param heading Start heading
+ * @param goals Bit x of goals[y] set for every goal cell (x, y)
+ * @param cost Time model
+ * @return The plan, with no motions if no goal is reachable
+ */
+SpeedRunPlan plan_speed_run(const WallMap &map, int x, int y, Direction heading,
+                            const std::vector<std::uint64_t> &goals,
+                            const MotionCost &cost = MotionCost{});
+
+/**
+ * @brief Drive the mouse through a plan
+ * @param mouse Mouse at the start of the plan
+ * @param plan Plan to execute
+ * @return false if a reset sent the mouse back to the start before the end
+ */
+bool execute_plan(Mouse &mouse, const SpeedRunPlan &plan);
+
+/**
+ * @brief Goal mask holding a single cell
+ * @param height Number of rows
+ * @param x Column of the cell
+ * @param y Row of the cell
+ * @return One mask per row
+ */
+std::vector<std::uint64_t> single_cell_goal(int height, int x, int y);
+
+} // namespace micro_mouse
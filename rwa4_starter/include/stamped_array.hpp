@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace micro_mouse {
+
+/**
+ * @brief Array whose elements can all be set back to a blank value at once
+ *
+ * Each element remembers the generation it was last written in, and only
+ * elements written in the current generation hold a value; the others read
+ * as blank. clear() starts a new generation, so it costs one increment
+ * whatever the size. The stamps are only wiped when the 32-bit generation
+ * counter wraps around.
+ *
+ * A stale element is overwritten with the blank value the first time it is
+ * written again, by assignment, so elements such as strings keep their
+ * capacity from one generation to the next.
+ * @tparam T Element type
+ */
+template <class T> class StampedArray {
+public:
+  /**
+   * @brief Size the array, all elements blank
+   * @param size Number of elements
+   * @param blank Value of the elements not written since the last clear()
+   */
+  void resize(std::size_t size, const T &blank = T{}) {
+    blank_ = blank;
+    values_.assign(size, blank);
+    stamps_.assign(size, 0);
+    generation_ = 1;
+  }
+
+  /**
+   * @brief Get the number of elements
+   * @return Size given to resize()
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return values_.size(); }
+
+  /**
+   * @brief Read an element
+   * @param i Index of the element
+   * @return Its value, blank if it was not written since the last clear()
+   */
+  [[nodiscard]] const T &get(std::size_t i) const noexcept {
+    return stamps_[i] == generation_ ? values_[i] : blank_;
+  }
+
+  /**
+   * @brief Access an element for writing
+   * @param i Index of the element
+   * @return The element, set to blank first if it was stale
+   */
+  T &at(std::size_t i) {
+    if (stamps_[i] != generation_) {
+      values_[i] = blank_;
+      stamps_[i] = generation_;
+    }
+    return values_[i];
+  }
+
+  /**
+   * @brief Write an element
+   * @param i Index of the element
+   * @param value Value to store
+   */
+  void set(std::size_t i, const T &value) { at(i) = value; }
+
+  /**
+   * @brief Set every element back to blank
+   */
+  void clear() noexcept {
+    if (++generation_ == 0) {
+      std::fill(stamps_.begin(), stamps_.end(), 0U);
+      generation_ = 1;
+    }
+  }
+
+private:
+  T blank_{};
+  std::vector<T> values_;
+  std::vector<std::uint32_t> stamps_;
+  std::uint32_t generation_{1};
+}; // class StampedArray
+
+} // namespace micro_mouse
@@ -0,0 +1,141 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace micro_mouse {
+
+/**
+ * @brief BucketQueue whose number of items and largest key are known at
+ * compile time
+ *
+ * Same buckets and same walk in key order as BucketQueue, but the lists
+ * are threaded through fixed std::arrays of 16-bit indices.
+ * @tparam Items Number of items
+ * @tparam MaxKey Largest key
+ */
+template <int Items, int MaxKey> class StaticBucketQueue {
+public:
+  static_assert(Items > 0 && Items <= 32767 && MaxKey >= 0 && MaxKey <= 32767,
+                "items and keys must fit in 16 bits");
+
+  /**
+   * @brief Construct an empty queue
+   */
+  StaticBucketQueue() noexcept {
+    heads_.fill(-1);
+    keys_.fill(-1);
+  }
+
+  /**
+   * @brief Check if an item is queued
+   * @param item Item
+   * @return true if the item is in the queue
+   */
+  [[nodiscard]] bool contains(int item) const noexcept {
+    return keys_[static_cast<std::size_t>(item)] >= 0;
+  }
+
+  /**
+   * @brief Get the key of an item
+   * @param item Item
+   * @return Its key, -1 if it is not queued
+   */
+  [[nodiscard]] int key(int item) const noexcept {
+    return keys_[static_cast<std::size_t>(item)];
+  }
+
+  /**
+   * @brief Count the queued items
+   * @return Number of items in the queue
+   */
+  [[nodiscard]] int size() const noexcept { return size_; }
+
+  /**
+   * @brief Queue an item, or change its key if it is queued already
+   * @param item Item
+   * @param key Key, at most MaxKey
+   */
+  void push(int item, int key) noexcept {
+    const auto i = static_cast<std::size_t>(item);
+    if (keys_[i] == key) {
+      return;
+    }
+    erase(item);
+    auto &head = heads_[static_cast<std::size_t>(key)];
+    next_[i] = head;
+    previous_[i] = -1;
+    if (head >= 0) {
+      previous_[static_cast<std::size_t>(head)] = static_cast<std::int16_t>(item);
+    }
+    head = static_cast<std::int16_t>(item);
+    keys_[i] = static_cast<std::int16_t>(key);
+    if (key < lowest_) {
+      lowest_ = key;
+    }
+    ++size_;
+  }
+
+  /**
+   * @brief Take an item out of the queue; nothing happens if it is not in
+   * @param item Item
+   */
+  void erase(int item) noexcept {
+    const auto i = static_cast<std::size_t>(item);
+    if (keys_[i] < 0) {
+      return;
+    }
+    if (previous_[i] >= 0) {
+      next_[static_cast<std::size_t>(previous_[i])] = next_[i];
+    } else {
+      heads_[static_cast<std::size_t>(keys_[i])] = next_[i];
+    }
+    if (next_[i] >= 0) {
+      previous_[static_cast<std::size_t>(next_[i])] = previous_[i];
+    }
+    keys_[i] = -1;
+    --size_;
+  }
+
+  /**
+   * @brief Get an item with the smallest key
+   * @return The item, -1 if the queue is empty
+   */
+  int first() noexcept {
+    if (size_ == 0) {
+      return -1;
+    }
+    while (heads_[static_cast<std::size_t>(lowest_)] < 0) {
+      ++lowest_;
+    }
+    return heads_[static_cast<std::size_t>(lowest_)];
+  }
+
+  /**
+   * @brief Get the item after @p item in key order
+   * @param item Queued item
+   * @return The next item, -1 after the last one
+   */
+  [[nodiscard]] int next(int item) const noexcept {
+    const auto i = static_cast<std::size_t>(item);
+    if (next_[i] >= 0) {
+      return next_[i];
+    }
+    for (auto key = static_cast<std::size_t>(keys_[i]) + 1; key < heads_.size(); ++key) {
+      if (heads_[key] >= 0) {
+        return heads_[key];
+      }
+    }
+    return -1;
+  }
+
+private:
+  std::array<std::int16_t, MaxKey + 1> heads_{}; // -1 if the bucket is empty
+  std::array<std::int16_t, Items> next_{};
+  std::array<std::int16_t, Items> previous_{};
+  std::array<std::int16_t, Items> keys_{};
+  int size_{0};
+  int lowest_{MaxKey + 1}; // No bucket below it holds an item
+}; // class StaticBucketQueue
+
+} // namespace micro_mouse
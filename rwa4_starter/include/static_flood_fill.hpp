@@ -0,0 +1,216 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "flood_fill.hpp"
+#include "maze_types.hpp"
+#include "static_wall_map.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief FloodFill for a maze whose size is known at compile time
+ *
+ * Same field and same modified flood fill as FloodFill, but the walls,
+ * distances and work lists live in fixed std::arrays and every neighbour
+ * lookup comes from the compile-time table of StaticWallMap. The field
+ * keeps its own record of walls, so add_wall() both records and repairs.
+ * @tparam W Number of columns
+ * @tparam H Number of rows
+ */
+template <int W, int H> class StaticFloodFill {
+public:
+  using Map = StaticWallMap<W, H>;
+
+  /**
+   * @brief Construct the field over an empty maze and flood it
+   */
+  StaticFloodFill() noexcept { recompute(); }
+
+  /**
+   * @brief Construct the field with the walls already known and flood it
+   * @param known Map of a W x H maze
+   */
+  explicit StaticFloodFill(const WallMap &known) noexcept {
+    for (int y{0}; y < H; ++y) {
+      for (int x{0}; x < W; ++x) {
+        for (const auto d : {Direction::NORTH, Direction::EAST}) {
+          if (known.has_wall(x, y, d)) {
+            map_.set_wall(x, y, d, true);
+          }
+        }
+      }
+    }
+    recompute();
+  }
+
+  /**
+   * @brief Flood the whole maze again from the center
+   */
+  void recompute() noexcept {
+    std::array<std::int16_t, Map::cells> queue{};
+    std::size_t tail{0};
+    for (int cell{0}; cell < Map::cells; ++cell) {
+      const bool goal{is_center[static_cast<std::size_t>(cell)]};
+      distances_[static_cast<std::size_t>(cell)] =
+          static_cast<std::int16_t>(goal ? 0 : unreachable());
+      if (goal) {
+        queue[tail++] = static_cast<std::int16_t>(cell);
+      }
+    }
+    for (std::size_t head{0}; head < tail; ++head) {
+      const int cell{queue[head]};
+      const auto next_distance =
+          static_cast<std::int16_t>(distances_[static_cast<std::size_t>(cell)] + 1);
+      for (int d{0}; d < 4; ++d) {
+        const int next{neighbour(cell, d)};
+        if (!map_.has_wall(cell, static_cast<Direction>(d)) &&
+            distances_[static_cast<std::size_t>(next)] == unreachable()) {
+          distances_[static_cast<std::size_t>(next)] = next_distance;
+          queue[tail++] = static_cast<std::int16_t>(next);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Record a wall and repair the field around it
+   *
+   * A repair that grows past a few passes over the maze (a wall that cuts
+   * cells off from the center) falls back to recompute().
+   * @param x X coordinate of a cell next to the wall
+   * @param y Y coordinate of a cell next to the wall
+   * @param d Side of (x, y) the wall is on
+   * @return Number of cells examined by the repair
+   */
+  std::size_t add_wall(int x, int y, Direction d) noexcept {
+    const int cell{Map::index(x, y)};
+    map_.set_wall(x, y, d, true);
+    push(cell);
+    const int other{neighbour(cell, static_cast<int>(d))};
+    if (other >= 0) {
+      push(other);
+    }
+    std::size_t touched{0};
+    while (pending_size_ > 0) {
+      const int current{pending_[--pending_size_]};
+      queued_[static_cast<std::size_t>(current)] = false;
+      ++touched;
+      if (touched > repair_limit) {
+        // The wall cut cells off from the center: their distances would
+        // only climb a step per pass until unreachable(), so flood afresh
+        while (pending_size_ > 0) {
+          queued_[static_cast<std::size_t>(pending_[--pending_size_])] = false;
+        }
+        recompute();
+        touched += Map::cells;
+        break;
+      }
+      const int expected{expected_distance(current)};
+      auto &distance = distances_[static_cast<std::size_t>(current)];
+      if (distance == expected) {
+        continue;
+      }
+      distance = static_cast<std::int16_t>(expected);
+      for (int n{0}; n < 4; ++n) {
+        if (!map_.has_wall(current, static_cast<Direction>(n))) {
+          push(neighbour(current, n));
+        }
+      }
+    }
+    ++stats_.walls;
+    stats_.cells_touched += touched;
+    return touched;
+  }
+
+  /**
+   * @brief Get the distance of a cell to the center
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @return Number of moves, unreachable() if there is no path
+   */
+  [[nodiscard]] int distance(int x, int y) const noexcept {
+    return distances_[static_cast<std::size_t>(Map::index(x, y))];
+  }
+
+  /**
+   * @brief Check if a wall was recorded on a side of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @return true if the side is walled; unknown sides count as open
+   */
+  [[nodiscard]] bool has_wall(int x, int y, Direction d) const noexcept {
+    return map_.has_wall(Map::index(x, y), d);
+  }
+
+  /**
+   * @brief Distance given to cells with no path to the center
+   * @return A value larger than any real distance
+   */
+  static constexpr int unreachable() noexcept { return W * H; }
+
+  /**
+   * @brief Get the repair counters
+   * @return Walls reported and cells examined so far
+   */
+  [[nodiscard]] const RepairStats &get_stats() const noexcept {
+    return stats_;
+  }
+
+private:
+  static constexpr std::array<bool, W * H> is_center{[] {
+    std::array<bool, W * H> table{};
+    for (int y{0}; y < H; ++y) {
+      for (int x{0}; x < W; ++x) {
+        table[static_cast<std::size_t>(Map::index(x, y))] =
+            is_center_cell(x, y, W, H);
+      }
+    }
+    return table;
+  }()};
+
+  // Cells a repair may examine before a full flood is cheaper
+  static constexpr std::size_t repair_limit{4 * static_cast<std::size_t>(W * H)};
+
+  static int neighbour(int cell, int d) noexcept {
+    return Map::neighbours[static_cast<std::size_t>(cell)]
+                          [static_cast<std::size_t>(d)];
+  }
+
+  // Distance (cell) should have given its neighbours
+  [[nodiscard]] int expected_distance(int cell) const noexcept {
+    if (is_center[static_cast<std::size_t>(cell)]) {
+      return 0;
+    }
+    int best{unreachable()};
+    for (int d{0}; d < 4; ++d) {
+      if (!map_.has_wall(cell, static_cast<Direction>(d))) {
+        best = std::min(best,
+                        distances_[static_cast<std::size_t>(neighbour(cell, d))] + 1);
+      }
+    }
+    return std::min(best, unreachable());
+  }
+
+  // A cell is on the work list at most once, so W * H entries suffice
+  void push(int cell) noexcept {
+    auto &queued = queued_[static_cast<std::size_t>(cell)];
+    if (!queued) {
+      queued = true;
+      pending_[pending_size_++] = static_cast<std::int16_t>(cell);
+    }
+  }
+
+  Map map_;
+  std::array<std::int16_t, W * H> distances_{};
+  std::array<std::int16_t, W * H> pending_{};
+  std::array<bool, W * H> queued_{};
+  std::size_t pending_size_{0};
+  RepairStats stats_;
+}; // class StaticFloodFill
+
+} // namespace micro_mouse
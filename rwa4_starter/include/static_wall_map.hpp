@@ -0,0 +1,135 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "maze_types.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Wall knowledge of a maze whose size is known at compile time
+ *
+ * One wall mask and one known mask per cell (see wall_bit()), both in
+ * fixed std::arrays, with the neighbour of every cell in every direction
+ * precomputed at compile time. An edge is stored on both cells sharing it.
+ * Used for the common 16x16 and 32x32 mazes; WallMap covers the rest.
+ * @tparam W Number of columns
+ * @tparam H Number of rows
+ */
+template <int W, int H> class StaticWallMap {
+public:
+  static_assert(W > 0 && H > 0 && W * H <= 32767,
+                "cell indices must fit in 16 bits");
+
+  static constexpr int width{W};      ///< Number of columns
+  static constexpr int height{H};     ///< Number of rows
+  static constexpr int cells{W * H};  ///< Number of cells
+
+  /**
+   * @brief Index of a cell
+   * @param x X coordinate
+   * @param y Y coordinate
+   * @return y * W + x
+   */
+  static constexpr int index(int x, int y) noexcept { return y * W + x; }
+
+  /**
+   * @brief Neighbour of every cell in every direction
+   *
+   * neighbours[cell][d] is the index of the next cell in direction d, or
+   * -1 past the boundary.
+   */
+  static constexpr std::array<std::array<std::int16_t, 4>, W * H> neighbours{
+      [] {
+        std::array<std::array<std::int16_t, 4>, W * H> table{};
+        for (int y{0}; y < H; ++y) {
+          for (int x{0}; x < W; ++x) {
+            for (int d{0}; d < 4; ++d) {
+              const int nx{x + dx_of(static_cast<Direction>(d))};
+              const int ny{y + dy_of(static_cast<Direction>(d))};
+              const bool inside{nx >= 0 && ny >= 0 && nx < W && ny < H};
+              table[static_cast<std::size_t>(y * W + x)]
+                   [static_cast<std::size_t>(d)] =
+                       static_cast<std::int16_t>(inside ? ny * W + nx : -1);
+            }
+          }
+        }
+        return table;
+      }()};
+
+  /**
+   * @brief Construct a map where only the outer boundary is known
+   */
+  constexpr StaticWallMap() noexcept {
+    for (int x{0}; x < W; ++x) {
+      set_wall(x, 0, Direction::SOUTH, true);
+      set_wall(x, H - 1, Direction::NORTH, true);
+    }
+    for (int y{0}; y < H; ++y) {
+      set_wall(0, y, Direction::WEST, true);
+      set_wall(W - 1, y, Direction::EAST, true);
+    }
+  }
+
+  /**
+   * @brief Check if a side of a cell is known to be walled
+   * @param cell Index of the cell
+   * @param d Side of the cell
+   * @return true if a wall was recorded there
+   */
+  [[nodiscard]] constexpr bool has_wall(int cell, Direction d) const noexcept {
+    return (walls_[static_cast<std::size_t>(cell)] & wall_bit(d)) != 0;
+  }
+
+  /**
+   * @brief Check if a side of a cell has been observed
+   * @param cell Index of the cell
+   * @param d Side of the cell
+   * @return true if the side is known to be walled or open
+   */
+  [[nodiscard]] constexpr bool is_known(int cell, Direction d) const noexcept {
+    return (known_[static_cast<std::size_t>(cell)] & wall_bit(d)) != 0;
+  }
+
+  /**
+   * @brief Get the walls of a cell
+   * @param cell Index of the cell
+   * @return Mask of the walled sides
+   */
+  [[nodiscard]] constexpr std::uint8_t walls(int cell) const noexcept {
+    return walls_[static_cast<std::size_t>(cell)];
+  }
+
+  /**
+   * @brief Record an observation of one side of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @param wall true if a wall is present
+   * @return true if the edge was not known before
+   */
+  constexpr bool set_wall(int x, int y, Direction d, bool wall) noexcept {
+    const int cell{index(x, y)};
+    const bool was_known{is_known(cell, d)};
+    record(cell, d, wall);
+    const int next{neighbours[static_cast<std::size_t>(cell)]
+                             [static_cast<std::size_t>(d)]};
+    if (next >= 0) {
+      record(next, opposite_of(d), wall);
+    }
+    return !was_known;
+  }
+
+private:
+  constexpr void record(int cell, Direction d, bool wall) noexcept {
+    const auto i = static_cast<std::size_t>(cell);
+    known_[i] = static_cast<std::uint8_t>(known_[i] | wall_bit(d));
+    walls_[i] = static_cast<std::uint8_t>(wall ? walls_[i] | wall_bit(d)
+                                               : walls_[i] & ~wall_bit(d));
+  }
+
+  std::array<std::uint8_t, W * H> walls_{};
+  std::array<std::uint8_t, W * H> known_{};
+}; // class StaticWallMap
+
+} // namespace micro_mouse
@@ -0,0 +1,117 @@
+#pragma once
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+#include "binary_framing.hpp"
+#include "command_channel.hpp"
+#include "maze_backend.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Backend speaking the mms text protocol over a pair of streams
+ *
+ * This is the default backend; it is bound to std::cin/std::cout when the
+ * program runs under the mms simulator.
+ *
+ * A step (see start_step()) goes out as one write, and its replies are only
+ * read by finish_step(), so the mouse can plan while the simulator moves.
+ *
+ * If allowed to, the backend switches to the binary framing when the
+ * simulator offers it in its reply to the first maze_width().
+ */
+class StreamBackend : public MazeBackend {
+public:
+  /**
+   * @brief Construct a backend over a pair of streams
+   * @param in Stream the simulator replies are read from
+   * @param out Stream the commands are written to
+   */
+  StreamBackend(std::istream &in, std::ostream &out) : channel_{in, out} {}
+
+  int maze_width() override;
+  int maze_height() override;
+  bool wall_front() override;
+  bool wall_right() override;
+  bool wall_left() override;
+  bool move_forward(int distance) override;
+  void turn_right() override;
+  void turn_left() override;
+  void set_wall(int x, int y, char direction) override;
+  void clear_wall(int x, int y, char direction) override;
+  void set_color(int x, int y, char color) override;
+  void clear_color(int x, int y) override;
+  void clear_all_color() override;
+  void set_text(int x, int y, const std::string &text) override;
+  void clear_text(int x, int y) override;
+  void clear_all_text() override;
+  bool was_reset() override;
+  void ack_reset() override;
+  void queue_was_reset() override;
+  bool take_was_reset() override;
+  void start_step(const StepRequest &step) override;
+  StepReply finish_step() override;
+  bool step_answered() override {
+    return !overlap_steps_ || channel_.replies_arrived();
+  }
+  [[nodiscard]] bool overlaps_steps() const override { return overlap_steps_; }
+  void flush() override { channel_.flush(); }
+  [[nodiscard]] ChannelStats get_stats() const override {
+    return channel_.get_stats();
+  }
+  void reset_stats() override { channel_.reset_stats(); }
+
+  /**
+   * @brief Choose whether steps are sent as soon as they start
+   * @param overlap false to run steps command by command, as other
+   * backends do
+   */
+  void set_step_overlap(bool overlap) noexcept { overlap_steps_ = overlap; }
+
+  /**
+   * @brief Read the replies on a thread of their own
+   *
+   * Step replies then carry the time they actually arrived. The input
+   * stream must end before the backend is destroyed.
+   */
+  void start_reader() { channel_.start_reader(); }
+
+  /**
+   * @brief Choose whether to take up an offer of the binary framing
+   *
+   * The offer comes with the reply to maze_width(), so this must be set
+   * before the first command and the reader thread is started. mms makes
+   * no offer and keeps talking text.
+   * @param accept true to switch to binary frames when offered
+   */
+  void set_binary_framing(bool accept) noexcept { accept_binary_ = accept; }
+
+  /**
+   * @brief Check the framing in use
+   * @return true once the binary framing was negotiated
+   */
+  [[nodiscard]] bool is_binary() const noexcept { return channel_.is_binary(); }
+
+private:
+  // Command without arguments in the framing in use
+  [[nodiscard]] std::string_view command(FrameOp op,
+                                         std::string_view text) const noexcept;
+  // Queue or send a move in the framing in use
+  std::string_view request_move(int distance);
+  void send_move(int distance);
+  // Whether a reply says yes: @p word in text, byte 1 in binary
+  [[nodiscard]] bool says(std::string_view reply,
+                          std::string_view word) const noexcept;
+  // Number carried by a reply
+  [[nodiscard]] int to_int(std::string_view reply) const noexcept;
+  // Report a failed move
+  void report_crash(std::string_view reply) const;
+
+  CommandChannel channel_;
+  bool accept_binary_{false};
+  bool overlap_steps_{true};
+  std::chrono::steady_clock::time_point step_sent_{};
+}; // class StreamBackend
+
+} // namespace micro_mouse
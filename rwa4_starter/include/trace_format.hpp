@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+
+namespace micro_mouse {
+
+/**
+ * @brief Backend call stored in a session trace
+ */
+enum class TraceOp : std::uint8_t {
+  MAZE_WIDTH,
+  MAZE_HEIGHT,
+  WALL_FRONT,
+  WALL_RIGHT,
+  WALL_LEFT,
+  MOVE_FORWARD,
+  TURN_RIGHT,
+  TURN_LEFT,
+  SET_WALL,
+  CLEAR_WALL,
+  SET_COLOR,
+  CLEAR_COLOR,
+  CLEAR_ALL_COLOR,
+  SET_TEXT,
+  CLEAR_TEXT,
+  CLEAR_ALL_TEXT,
+  WAS_RESET,
+  ACK_RESET,
+  QUEUE_WAS_RESET,
+  TAKE_WAS_RESET
+};
+
+/**
+ * @brief Check if a call only changes what the simulator shows
+ *
+ * These calls get no reply and do not change what the mouse senses.
+ * @param op Call to check
+ * @return true for wall marks, colors and texts
+ */
+constexpr bool is_display_op(TraceOp op) noexcept {
+  return op >= TraceOp::SET_WALL && op <= TraceOp::CLEAR_ALL_TEXT;
+}
+
+/**
+ * @brief One backend call in a session trace
+ *
+ * A trace file is the 8-byte trace_magic followed by the records in call
+ * order, in host byte order. The text of a SET_TEXT record follows it.
+ */
+struct TraceRecord {
+  std::uint64_t time_ns{0};        ///< Start of the call since recording began
+  std::uint32_t wait_ns{0};        ///< Time spent in the backend, saturated
+  std::int32_t value{0};           ///< Reply: size, wall, reset, move success
+  std::int16_t x{0};               ///< Cell column, or distance of MOVE_FORWARD
+  std::int16_t y{0};               ///< Cell row
+  TraceOp op{TraceOp::MAZE_WIDTH}; ///< Call
+  char argument{0};                ///< Direction or color
+  std::uint16_t text_length{0};    ///< Bytes of text after the record
+};
+static_assert(sizeof(TraceRecord) == 24, "the record layout is part of the file format");
+
+/// First bytes of a trace file
+constexpr char trace_magic[8]{'R', 'W', 'A', '4', 'T', 'R', 'C', '1'};
+
+} // namespace micro_mouse
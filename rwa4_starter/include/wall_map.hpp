@@ -0,0 +1,252 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "bit_array.hpp"
+#include "maze_types.hpp"
+
+namespace micro_mouse {
+
+/**
+ * @brief Bit-packed knowledge of the maze walls
+ *
+ * Every edge of the grid is stored once, so the two cells sharing an edge
+ * always agree. Horizontal edges (north/south sides) come first, one row of
+ * @c width bits per grid line; vertical edges (east/west sides) follow, one
+ * row of <tt>width + 1</tt> bits per cell row. A second array of the same
+ * layout tells which edges have been observed, and a bitmap records the
+ * visited cells. A 16x16 maze takes 18 words for the walls plus 4 for the
+ * visited cells.
+ *
+ * Row queries return one bit per cell, bit x for column x, so the maze
+ * width is limited to 64 cells.
+ */
+class WallMap {
+public:
+  /**
+   * @brief Construct a map where only the outer boundary is known
+   * @param width Number of columns, 1 to 64
+   * @param height Number of rows, at least 1
+   * @throw std::invalid_argument if a dimension is out of range
+   */
+  WallMap(int width, int height);
+
+  /**
+   * @brief Get the number of columns
+   * @return Width of the maze in cells
+   */
+  [[nodiscard]] int width() const noexcept { return width_; }
+
+  /**
+   * @brief Get the number of rows
+   * @return Height of the maze in cells
+   */
+  [[nodiscard]] int height() const noexcept { return height_; }
+
+  /**
+   * @brief Check if (x, y) lies in the maze
+   * @param x X coordinate
+   * @param y Y coordinate
+   * @return true if the cell exists
+   */
+  [[nodiscard]] bool contains(int x, int y) const noexcept {
+    return x >= 0 && y >= 0 && x < width_ && y < height_;
+  }
+
+  /**
+   * @brief Check if a side of a cell is known to be walled
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @return true if a wall was recorded there
+   */
+  [[nodiscard]] bool has_wall(int x, int y, Direction d) const noexcept {
+    return walls_.test(edge_index(x, y, d));
+  }
+
+  /**
+   * @brief Check if a side of a cell has been observed
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @return true if the side is known to be walled or open
+   */
+  [[nodiscard]] bool is_known(int x, int y, Direction d) const noexcept {
+    return known_.test(edge_index(x, y, d));
+  }
+
+  /**
+   * @brief Check if a side of a cell is known to be open
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @return true if the side was observed without a wall
+   */
+  [[nodiscard]] bool is_open(int x, int y, Direction d) const noexcept {
+    const std::size_t e{edge_index(x, y, d)};
+    return known_.test(e) && !walls_.test(e);
+  }
+
+  /**
+   * @brief Record an observation of one side of a cell
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @param wall true if a wall is present
+   * @return true if the edge was not known before
+   */
+  bool set_wall(int x, int y, Direction d, bool wall);
+
+  /**
+   * @brief Check if a cell has been visited
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @return true if the mouse has been in the cell
+   */
+  [[nodiscard]] bool is_visited(int x, int y) const noexcept {
+    return visited_.test(cell_index(x, y));
+  }
+
+  /**
+   * @brief Mark a cell as visited
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   */
+  void mark_visited(int x, int y) noexcept {
+    visited_.set(cell_index(x, y));
+  }
+
+  /**
+   * @brief Count the visited cells
+   * @return Number of visited cells
+   */
+  [[nodiscard]] std::size_t visited_count() const noexcept {
+    return visited_.count();
+  }
+
+  /**
+   * @brief Count the edges that have not been observed
+   * @return Number of unknown edges
+   */
+  [[nodiscard]] std::size_t unknown_edge_count() const noexcept {
+    return known_.size() - known_.count();
+  }
+
+  /**
+   * @brief Unknown north sides of a row
+   * @param y Row
+   * @return Bit x set if the north side of (x, y) is unknown
+   */
+  [[nodiscard]] std::uint64_t unknown_north(int y) const noexcept {
+    return ~known_.extract(north_row(y), row_bits()) & row_mask();
+  }
+
+  /**
+   * @brief Unknown east sides of a row
+   * @param y Row
+   * @return Bit x set if the east side of (x, y) is unknown
+   */
+  [[nodiscard]] std::uint64_t unknown_east(int y) const noexcept {
+    return ~known_.extract(east_row(y), row_bits()) & row_mask();
+  }
+
+  /**
+   * @brief Passable north sides of a row
+   * @param y Row
+   * @param optimistic Treat unknown sides as open
+   * @return Bit x set if the mouse may leave (x, y) northwards
+   */
+  [[nodiscard]] std::uint64_t open_north(int y, bool optimistic) const noexcept {
+    return open_bits(north_row(y), optimistic);
+  }
+
+  /**
+   * @brief Passable east sides of a row
+   * @param y Row
+   * @param optimistic Treat unknown sides as open
+   * @return Bit x set if the mouse may leave (x, y) eastwards
+   */
+  [[nodiscard]] std::uint64_t open_east(int y, bool optimistic) const noexcept {
+    return open_bits(east_row(y), optimistic);
+  }
+
+  /**
+   * @brief Unvisited cells of a row
+   * @param y Row
+   * @return Bit x set if (x, y) has not been visited
+   */
+  [[nodiscard]] std::uint64_t unvisited(int y) const noexcept {
+    return ~visited_.extract(cell_index(0, y), row_bits()) & row_mask();
+  }
+
+  /**
+   * @brief Access the wall bits, in the layout described above
+   * @return Bit set for every walled edge
+   */
+  [[nodiscard]] const BitArray &get_walls() const noexcept { return walls_; }
+
+  /**
+   * @brief Access the observed-edge bits
+   * @return Bit set for every known edge
+   */
+  [[nodiscard]] const BitArray &get_known() const noexcept { return known_; }
+
+  /**
+   * @brief Access the visited-cell bits
+   * @return Bit y * width + x set if (x, y) was visited
+   */
+  [[nodiscard]] const BitArray &get_visited() const noexcept {
+    return visited_;
+  }
+
+  /**
+   * @brief Replace the whole map with saved words
+   *
+   * Each pointer must hold as many words as the matching accessor.
+   * @param walls Words of get_walls()
+   * @param known Words of get_known()
+   * @param visited Words of get_visited()
+   */
+  void restore(const std::uint64_t *walls, const std::uint64_t *known,
+               const std::uint64_t *visited) noexcept {
+    walls_.assign(walls);
+    known_.assign(known);
+    visited_.assign(visited);
+  }
+
+  /**
+   * @brief Mask covering the cells of one row
+   * @return The @c width least significant bits set
+   */
+  [[nodiscard]] std::uint64_t row_mask() const noexcept {
+    return BitArray::low_mask(row_bits());
+  }
+
+private:
+  [[nodiscard]] std::size_t row_bits() const noexcept {
+    return static_cast<std::size_t>(width_);
+  }
+  [[nodiscard]] std::size_t cell_index(int x, int y) const noexcept {
+    return static_cast<std::size_t>(y * width_ + x);
+  }
+  // First bit of the north sides of row y
+  [[nodiscard]] std::size_t north_row(int y) const noexcept {
+    return static_cast<std::size_t>((y + 1) * width_);
+  }
+  // First bit of the east sides of row y
+  [[nodiscard]] std::size_t east_row(int y) const noexcept {
+    return vertical_base_ + static_cast<std::size_t>(y * (width_ + 1) + 1);
+  }
+  [[nodiscard]] std::size_t edge_index(int x, int y, Direction d) const noexcept;
+  [[nodiscard]] std::uint64_t open_bits(std::size_t pos,
+                                        bool optimistic) const noexcept;
+
+  int width_;
+  int height_;
+  std::size_t vertical_base_;
+  BitArray walls_;
+  BitArray known_;
+  BitArray visited_;
+}; // class WallMap
+
+} // namespace micro_mouse
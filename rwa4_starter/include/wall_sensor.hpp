@@ -0,0 +1,181 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "maze_rules.hpp"
+#include "maze_types.hpp"
+#include "wall_map.hpp"
+
+namespace micro_mouse {
+
+class MazeSession;
+
+/**
+ * @brief Counters of the wall queries answered by a WallSensor
+ */
+struct SensingStats {
+  std::size_t queries{0}; ///< Queries sent to the simulator
+  std::size_t avoided{0}; ///< Queries answered from the record of edges
+};
+
+/**
+ * @brief Hash of the first walls observed in a run
+ *
+ * The solver is deterministic, so on a given maze it always senses the same
+ * edges first; a dozen observations tell mazes of the same size apart.
+ */
+struct MazeFingerprint {
+  static constexpr int edges_needed{12}; ///< Observations that make the key
+
+  std::uint64_t hash{14695981039346656037ULL}; ///< FNV-1a of the observations
+  int edges{0};                               ///< Observations hashed so far
+
+  /**
+   * @brief Check if enough edges were observed
+   * @return true once the hash no longer changes
+   */
+  [[nodiscard]] bool complete() const noexcept { return edges >= edges_needed; }
+
+  /**
+   * @brief Hash one observation, unless the fingerprint is complete
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Side of the cell
+   * @param wall true if a wall was sensed
+   */
+  void add(int x, int y, Direction d, bool wall) noexcept {
+    if (complete()) {
+      return;
+    }
+    for (const int value : {x, y, static_cast<int>(d), wall ? 1 : 0}) {
+      hash = (hash ^ static_cast<std::uint64_t>(value)) * 1099511628211ULL;
+    }
+    ++edges;
+  }
+};
+
+/**
+ * @brief Sensing layer between the mouse and the simulator wall queries
+ *
+ * Keeps the record of every edge sensed so far. A query about an edge that
+ * is already known (the outer boundary, an edge sensed from the cell on the
+ * other side, or an earlier query) is answered locally; only unknown edges
+ * cost a round-trip.
+ *
+ * With use_maze_rules(), every sensed edge is also run through MazeRules,
+ * and the edges deduced are recorded (and walls displayed) as if sensed.
+ */
+class WallSensor {
+public:
+  /**
+   * @brief Construct a sensor that only knows the outer boundary
+   * @param session Session the queries are sent through
+   * @param width Number of columns
+   * @param height Number of rows
+   */
+  WallSensor(MazeSession &session, int width, int height)
+      : session_{session}, map_{width, height} {}
+
+  /**
+   * @brief Check for a wall on one side of the mouse's cell
+   *
+   * The side behind the mouse cannot be sensed; if it is unknown it is
+   * reported open without being recorded.
+   * @param x X coordinate of the mouse
+   * @param y Y coordinate of the mouse
+   * @param heading Heading of the mouse
+   * @param d Absolute side of the cell
+   * @return true if there is a wall
+   */
+  bool has_wall(int x, int y, Direction heading, Direction d);
+
+  /**
+   * @brief Check if a side of a cell still has to be sensed
+   *
+   * A known side counts as a query answered locally.
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Absolute side of the cell
+   * @return true if the side is unknown
+   */
+  bool needs_query(int x, int y, Direction d);
+
+  /**
+   * @brief Record the answer to a query sent by someone else
+   *
+   * For walls sensed as part of a step (see Mouse::start_step()).
+   * @param x X coordinate of the cell
+   * @param y Y coordinate of the cell
+   * @param d Absolute side of the cell
+   * @param wall true if there is a wall
+   */
+  void record(int x, int y, Direction d, bool wall);
+
+  /**
+   * @brief Deduce unseen edges from the rules of official mazes
+   *
+   * Only for mazes that follow them (see MazeRules).
+   */
+  void use_maze_rules();
+
+  /**
+   * @brief Get the edges deduced since the last clear_inferred()
+   * @return Deduced edges, empty without maze rules
+   */
+  [[nodiscard]] const std::vector<InferredEdge> &get_inferred() const noexcept;
+
+  /**
+   * @brief Forget the edges returned by get_inferred()
+   */
+  void clear_inferred() noexcept;
+
+  /**
+   * @brief Get the deduction counters
+   * @return Edges deduced so far, by rule; zero without maze rules
+   */
+  [[nodiscard]] InferenceStats get_inference_stats() const noexcept;
+
+  /**
+   * @brief Get the record of sensed edges
+   * @return The wall map
+   */
+  [[nodiscard]] const WallMap &get_map() const noexcept { return map_; }
+
+  /**
+   * @brief Get the record of sensed edges for update
+   * @return The wall map
+   */
+  [[nodiscard]] WallMap &get_map() noexcept { return map_; }
+
+  /**
+   * @brief Get the query counters
+   * @return Queries sent and avoided so far
+   */
+  [[nodiscard]] const SensingStats &get_stats() const noexcept {
+    return stats_;
+  }
+
+  /**
+   * @brief Get the hash of the first edges sensed through the simulator
+   * @return The fingerprint of the maze
+   */
+  [[nodiscard]] const MazeFingerprint &get_fingerprint() const noexcept {
+    return fingerprint_;
+  }
+
+private:
+  // Run the rules on an edge that became known and display the walls found
+  void infer_from(int x, int y, Direction d);
+  // Display the walls among the deductions from index first on
+  void show_inferred(std::size_t first);
+
+  MazeSession &session_;
+  WallMap map_;
+  std::optional<MazeRules> rules_;
+  SensingStats stats_;
+  MazeFingerprint fingerprint_;
+}; // class WallSensor
+
+} // namespace micro_mouse
@@ -0,0 +1,1336 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "cpu_time.hpp"
+#include "distance_kernel.hpp"
+#include "loopback_link.hpp"
+#include "maze_session.hpp"
+#include "maze_file.hpp"
+#include "maze_memory.hpp"
+#include "maze_simulator.hpp"
+#include "mouse.hpp"
+#include "navigator.hpp"
+#include "protocol_server.hpp"
+#include "solver_policy.hpp"
+#include "static_flood_fill.hpp"
+#include "stream_backend.hpp"
+#include "wall_map.hpp"
+
+namespace {
+// Heap allocations made by each thread, read by the alloc check. Per thread
+// so that the corpus workers do not contend on a shared counter.
+thread_local std::size_t allocation_count{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+using DistanceKernel = void (*)(const micro_mouse::WallMap&,
+                                const std::vector<std::uint64_t>&, bool,
+                                std::vector<int>&);
+
+/**
+ * @brief Metrics of one solver run on one maze
+ */
+struct MazeMetrics {
+    std::string maze;
+    int solved{0};
+    int cells_explored{0};
+    int exploration_moves{0};
+    int moves{0};
+    int turns{0};
+    std::size_t commands{0};
+    std::size_t round_trips{0};
+    double solver_cpu_seconds{0.0};
+    double wall_seconds{0.0};
+};
+
+/**
+ * @brief Run the mouse on one maze through the text protocol
+ *
+ * The mouse talks to a MazeSimulator through a StreamBackend, a
+ * LoopbackLink and a ProtocolServer, i.e., the same protocol as mms.
+ * @param path Maze file
+ * @param binary Negotiate the binary framing instead of staying with text
+ * @param explorer Exploration to the center
+ * @return Metrics of the run; solver CPU time excludes the server side
+ */
+MazeMetrics run_maze(const std::string& path, bool binary,
+                     micro_mouse::Explorer explorer) {
+    micro_mouse::MazeSimulator simulator{micro_mouse::load_maze_file(path)};
+    micro_mouse::ProtocolServer server{simulator};
+    server.set_binary_offer(binary);
+    micro_mouse::LoopbackLink link{server};
+    micro_mouse::StreamBackend client{link.client_in(), link.client_out()};
+    client.set_binary_framing(binary);
+    micro_mouse::MazeSession session{client};
+
+    // Generous budget: a mouse that explores every cell twice still fits
+    const auto& layout = simulator.get_layout();
+    const int max_moves{4 * layout.width * layout.height};
+    const double cpu_start{micro_mouse::thread_cpu_seconds()};
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = micro_mouse::run_mouse(session, false, max_moves, false,
+                                               micro_mouse::Exploration::TO_CENTER,
+                                               explorer);
+    session.flush();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const double cpu{micro_mouse::thread_cpu_seconds() - cpu_start};
+
+    MazeMetrics metrics;
+    metrics.maze = std::filesystem::path{path}.filename().string();
+    metrics.solved = result.reached_center ? 1 : 0;
+    metrics.cells_explored = result.cells_explored;
+    metrics.exploration_moves = result.moves;
+    metrics.moves = simulator.get_run_stats().moves;
+    metrics.turns = simulator.get_run_stats().turns;
+    metrics.commands = client.get_stats().commands;
+    metrics.round_trips = client.get_stats().round_trips;
+    metrics.solver_cpu_seconds = cpu - link.get_server_seconds();
+    metrics.wall_seconds = elapsed.count();
+    return metrics;
+}
+
+void add_to(MazeMetrics& total, const MazeMetrics& m) {
+    total.solved += m.solved;
+    total.cells_explored += m.cells_explored;
+    total.exploration_moves += m.exploration_moves;
+    total.moves += m.moves;
+    total.turns += m.turns;
+    total.commands += m.commands;
+    total.round_trips += m.round_trips;
+    total.solver_cpu_seconds += m.solver_cpu_seconds;
+    total.wall_seconds += m.wall_seconds;
+}
+
+void print_csv(const std::vector<MazeMetrics>& rows, const MazeMetrics& total) {
+    std::cout << "maze,solved,cells_explored,moves,turns,commands,round_trips,"
+                 "solver_cpu_s,wall_s\n";
+    const auto print_row = [](const MazeMetrics& m) {
+        std::cout << m.maze << ',' << m.solved << ',' << m.cells_explored << ','
+                  << m.moves << ',' << m.turns << ',' << m.commands << ','
+                  << m.round_trips << ',' << m.solver_cpu_seconds << ','
+                  << m.wall_seconds << '\n';
+    };
+    for (const auto& m : rows) {
+        print_row(m);
+    }
+    print_row(total);
+}
+
+void print_json(const std::vector<MazeMetrics>& rows, const MazeMetrics& total) {
+    const auto print_object = [](const MazeMetrics& m) {
+        std::cout << "{\"maze\": \"" << m.maze << "\", \"solved\": " << m.solved
+                  << ", \"cells_explored\": " << m.cells_explored
+                  << ", \"moves\": " << m.moves << ", \"turns\": " << m.turns
+                  << ", \"commands\": " << m.commands
+                  << ", \"round_trips\": " << m.round_trips
+                  << ", \"solver_cpu_s\": " << m.solver_cpu_seconds
+                  << ", \"wall_s\": " << m.wall_seconds << '}';
+    };
+    std::cout << "{\n  \"mazes\": [";
+    for (std::size_t i{0}; i < rows.size(); ++i) {
+        std::cout << (i == 0 ? "\n    " : ",\n    ");
+        print_object(rows[i]);
+    }
+    std::cout << "\n  ],\n  \"total\": ";
+    print_object(total);
+    std::cout << "\n}\n";
+}
+
+/**
+ * @brief List the maze files of a directory
+ * @param directory Directory holding the maze files
+ * @return Paths of the .txt, .num and .map files, sorted
+ */
+std::vector<std::string> maze_files(const std::string& directory) {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+        const auto extension = entry.path().extension();
+        if (entry.is_regular_file() &&
+            (extension == ".txt" || extension == ".num" || extension == ".map")) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+/**
+ * @brief Run the mouse on a set of mazes
+ *
+ * Each maze gets its own simulator and MazeSession, so the mazes are
+ * spread over @p jobs worker threads; the rows are reported in file order
+ * whatever the thread that ran them.
+ * @param files Maze files
+ * @param jobs Number of worker threads
+ * @param binary Talk binary frames instead of text lines
+ * @param explorer Exploration to the center
+ * @param rows Receives the metrics of the mazes that could be run
+ * @return Totals over @p rows
+ */
+MazeMetrics run_corpus(const std::vector<std::string>& files, unsigned jobs,
+                       bool binary, micro_mouse::Explorer explorer,
+                       std::vector<MazeMetrics>& rows) {
+    std::vector<MazeMetrics> results(files.size());
+    std::vector<std::string> errors(files.size());
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&] {
+        for (std::size_t i{next++}; i < files.size(); i = next++) {
+            try {
+                results[i] = run_maze(files[i], binary, explorer);
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t{1}; t < jobs; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    rows.clear();
+    MazeMetrics total;
+    total.maze = "TOTAL";
+    for (std::size_t i{0}; i < files.size(); ++i) {
+        if (!errors[i].empty()) {
+            std::cerr << files[i] << ": " << errors[i] << '\n';
+            continue;
+        }
+        rows.push_back(results[i]);
+        add_to(total, rows.back());
+    }
+    return total;
+}
+
+/**
+ * @brief Run the mouse on every maze file of a directory
+ * @param directory Directory holding the maze files
+ * @param json Print JSON instead of CSV
+ * @param jobs Number of worker threads
+ * @param binary Talk binary frames instead of text lines
+ * @param explorer Exploration to the center
+ * @return Process exit status
+ */
+int bench_corpus(const std::string& directory, bool json, unsigned jobs, bool binary,
+                 micro_mouse::Explorer explorer) {
+    const auto files = maze_files(directory);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<MazeMetrics> rows;
+    const MazeMetrics total{run_corpus(files, jobs, binary, explorer, rows)};
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cerr << files.size() << " mazes on " << jobs << " threads in "
+              << elapsed.count() << " s\n";
+    if (json) {
+        print_json(rows, total);
+    } else {
+        print_csv(rows, total);
+    }
+    return 0;
+}
+
+/**
+ * @brief Run every registered solver on every maze file of a directory
+ * @param directory Directory holding the maze files
+ * @param jobs Number of worker threads
+ * @return Process exit status
+ */
+int bench_solvers(const std::string& directory, unsigned jobs) {
+    const auto files = maze_files(directory);
+    std::cout << "solver,mazes,solved,cells_explored,exploration_moves,moves,turns,"
+                 "solver_cpu_s,cpu_us_per_maze,cpu_us_per_move\n";
+    std::vector<MazeMetrics> rows;
+    for (const auto& solver : micro_mouse::solver_registry()) {
+        const MazeMetrics total{run_corpus(files, jobs, false, solver.explore, rows)};
+        const double mazes{static_cast<double>(std::max<std::size_t>(rows.size(), 1))};
+        std::cout << solver.name << ',' << rows.size() << ',' << total.solved << ','
+                  << total.cells_explored << ',' << total.exploration_moves << ','
+                  << total.moves << ',' << total.turns
+                  << ',' << total.solver_cpu_seconds << ','
+                  << total.solver_cpu_seconds / mazes * 1e6 << ','
+                  << total.solver_cpu_seconds / std::max(total.moves, 1) * 1e6 << '\n';
+    }
+    return 0;
+}
+
+/**
+ * @brief Time a distance kernel
+ * @return Average nanoseconds per call
+ */
+double time_kernel(DistanceKernel kernel, const micro_mouse::WallMap& map,
+                   bool optimistic, int repetitions, std::vector<int>& distances) {
+    const auto seeds = micro_mouse::center_seeds(map.width(), map.height());
+    const auto start = std::chrono::steady_clock::now();
+    for (int i{0}; i < repetitions; ++i) {
+        kernel(map, seeds, optimistic, distances);
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repetitions;
+}
+
+/**
+ * @brief Compare the scalar and wavefront kernels on one map
+ * @return false if the kernels disagree
+ */
+bool compare_kernels(const std::string& name, const micro_mouse::WallMap& map,
+                     bool optimistic) {
+    constexpr int repetitions{20000};
+    std::vector<int> scalar;
+    std::vector<int> wavefront;
+    const double scalar_ns{time_kernel(micro_mouse::scalar_distances, map,
+                                       optimistic, repetitions, scalar)};
+    const double wavefront_ns{time_kernel(micro_mouse::wavefront_distances, map,
+                                          optimistic, repetitions, wavefront)};
+    const bool same{scalar == wavefront};
+    std::cout << name << (optimistic ? ",optimistic," : ",known,") << map.width()
+              << 'x' << map.height() << ',' << scalar_ns << ',' << wavefront_ns
+              << ',' << scalar_ns / wavefront_ns << ',' << (same ? "ok" : "MISMATCH")
+              << '\n';
+    return same;
+}
+
+/**
+ * @brief Compare the distance kernels on an empty map and on given mazes
+ * @return Process exit status, non-zero if the kernels disagree
+ */
+int bench_kernels(const std::vector<std::string>& files) {
+    std::cout << "maze,walls,size,scalar_ns,wavefront_ns,speedup,check\n";
+    bool ok{true};
+    ok = compare_kernels("empty", micro_mouse::WallMap{16, 16}, true) && ok;
+    ok = compare_kernels("empty", micro_mouse::WallMap{32, 32}, true) && ok;
+    for (const auto& file : files) {
+        const auto map = micro_mouse::make_wall_map(micro_mouse::load_maze_file(file));
+        ok = compare_kernels(file, map, false) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Time one pass over all center goals against one flood per goal
+ *
+ * The four floods give the distance to each goal; their minimum and which
+ * goal reaches it must match the single pass, which must also match the
+ * scalar kernel.
+ * @return false if the results disagree
+ */
+bool compare_goal_kernels(const std::string& name, const micro_mouse::WallMap& map) {
+    constexpr int repetitions{20000};
+    const int width{map.width()};
+    const int height{map.height()};
+    const auto center = micro_mouse::center_seeds(width, height);
+    std::vector<std::vector<std::uint64_t>> goals;
+    for (int y{0}; y < height; ++y) {
+        for (int x{0}; x < width; ++x) {
+            if (micro_mouse::is_center_cell(x, y, width, height)) {
+                goals.push_back(micro_mouse::single_cell_goal(height, x, y));
+            }
+        }
+    }
+    std::vector<std::vector<int>> per_goal(goals.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int i{0}; i < repetitions; ++i) {
+        for (std::size_t g{0}; g < goals.size(); ++g) {
+            micro_mouse::wavefront_distances(map, goals[g], false, per_goal[g]);
+        }
+    }
+    const std::chrono::duration<double, std::nano> floods =
+        std::chrono::steady_clock::now() - start;
+    std::vector<int> distances;
+    std::vector<std::uint8_t> nearest;
+    start = std::chrono::steady_clock::now();
+    for (int i{0}; i < repetitions; ++i) {
+        micro_mouse::wavefront_nearest_goals(map, center, false, distances, nearest);
+    }
+    const std::chrono::duration<double, std::nano> one_pass =
+        std::chrono::steady_clock::now() - start;
+
+    bool same{true};
+    for (std::size_t cell{0}; cell < distances.size(); ++cell) {
+        int best{width * height};
+        std::uint8_t best_goal{micro_mouse::no_goal};
+        for (std::size_t g{0}; g < goals.size(); ++g) {
+            if (per_goal[g][cell] < best) {
+                best = per_goal[g][cell];
+                best_goal = static_cast<std::uint8_t>(g);
+            }
+        }
+        same = same && distances[cell] == best && nearest[cell] == best_goal;
+    }
+    std::vector<int> scalar_distances;
+    std::vector<std::uint8_t> scalar_nearest;
+    micro_mouse::scalar_nearest_goals(map, center, false, scalar_distances, scalar_nearest);
+    same = same && scalar_distances == distances && scalar_nearest == nearest;
+    std::cout << name << ',' << width << 'x' << height << ',' << goals.size() << ','
+              << floods.count() / repetitions << ',' << one_pass.count() / repetitions
+              << ',' << floods.count() / one_pass.count() << ','
+              << (same ? "ok" : "MISMATCH") << '\n';
+    return same;
+}
+
+/**
+ * @brief Compare the nearest-goal kernel with one flood per goal on mazes
+ * @return Process exit status, non-zero if the results disagree
+ */
+int bench_goals(const std::vector<std::string>& files) {
+    std::cout << "maze,size,goals,per_goal_ns,one_pass_ns,speedup,check\n";
+    bool ok{true};
+    for (const auto& file : files) {
+        const auto map = micro_mouse::make_wall_map(micro_mouse::load_maze_file(file));
+        ok = compare_goal_kernels(file, map) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Load a maze file through std::ifstream and the stream parsers
+ */
+micro_mouse::WallMap load_through_stream(const std::string& path) {
+    std::ifstream file{path};
+    char first{' '};
+    while (file.get(first) && std::isspace(static_cast<unsigned char>(first))) {
+    }
+    file.clear();
+    file.seekg(0);
+    return micro_mouse::make_wall_map(std::isdigit(static_cast<unsigned char>(first))
+                                          ? micro_mouse::parse_num_maze(file)
+                                          : micro_mouse::parse_map_maze(file));
+}
+
+/**
+ * @brief Check that both loaders reject malformed .num files
+ * @return true if every file was rejected with std::invalid_argument
+ */
+bool check_rejected_mazes() {
+    // Name and contents of each file
+    const std::pair<const char*, const char*> mazes[]{
+        {"negative coordinate", "0 -1 1 0 1 1\n"},
+        {"missing side", "0 0 1 0 1\n"},
+        {"too wide", "64 0 1 0 1 1\n"},
+        {"too high", "0 0 1 0 1 1\n0 100000000 1 0 1 1\n"},
+    };
+    bool ok{true};
+    for (const auto& [name, text] : mazes) {
+        const auto rejected = [](auto parse) {
+            try {
+                parse();
+            } catch (const std::invalid_argument&) {
+                return true;
+            }
+            return false;
+        };
+        if (!rejected([&] { micro_mouse::parse_wall_map(text); })) {
+            std::cerr << name << ": accepted by the memory-mapped parser\n";
+            ok = false;
+        }
+        if (!rejected([&] {
+                std::istringstream in{text};
+                micro_mouse::parse_num_maze(in);
+            })) {
+            std::cerr << name << ": accepted by the stream parser\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Compare loading mazes through streams with the memory-mapped parser
+ *
+ * Malformed files are checked to be rejected by both parsers. Each file is
+ * loaded both ways and the maps checked to match, then the whole list is
+ * loaded @p passes times each way.
+ * @return Process exit status, non-zero if a map differs or a malformed
+ * file is accepted
+ */
+int bench_load(const std::vector<std::string>& files, int passes) {
+    bool ok{check_rejected_mazes()};
+    for (const auto& file : files) {
+        try {
+            const auto streamed = load_through_stream(file);
+            const auto mapped = micro_mouse::load_wall_map(file);
+            if (streamed.get_walls().words() != mapped.get_walls().words() ||
+                streamed.get_known().words() != mapped.get_known().words() ||
+                streamed.get_visited().words() != mapped.get_visited().words()) {
+                std::cerr << file << ": the maps differ\n";
+                ok = false;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << file << ": " << e.what() << '\n';
+            return 1;
+        }
+    }
+    const auto time_loads = [&](auto load) {
+        std::size_t cells{0};
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass{0}; pass < passes; ++pass) {
+            for (const auto& file : files) {
+                cells += load(file).visited_count();
+            }
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return std::make_pair(elapsed.count(), cells);
+    };
+    const auto [stream_seconds, stream_cells] = time_loads(load_through_stream);
+    const auto [mapped_seconds, mapped_cells] = time_loads(
+        [](const std::string& file) { return micro_mouse::load_wall_map(file); });
+    const double loads{static_cast<double>(files.size()) * passes};
+    std::cout << "loader,loads,seconds,loads_per_s,cells\n"
+              << "stream," << loads << ',' << stream_seconds << ','
+              << loads / stream_seconds << ',' << stream_cells << '\n'
+              << "mapped," << loads << ',' << mapped_seconds << ','
+              << loads / mapped_seconds << ',' << mapped_cells << '\n';
+    return ok && stream_cells == mapped_cells ? 0 : 1;
+}
+
+/**
+ * @brief Output buffer that drops everything written to it
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+/**
+ * @brief Count the heap allocations of a scripted protocol session
+ *
+ * The replies of the whole session are prepared up front, then a
+ * StreamBackend issues @p commands commands mixing queries, motions and
+ * display updates. The protocol layer must not allocate once warm.
+ * @return Process exit status, non-zero if an allocation was seen
+ */
+int bench_allocations(int commands) {
+    constexpr int pattern_length{10};
+    const int rounds{commands / pattern_length};
+    std::string replies;
+    replies.reserve(static_cast<std::size_t>(rounds) * 40);
+    for (int i{0}; i < rounds + 1; ++i) {
+        replies += "true\nfalse\nfalse\nack\nack\n16\n";
+    }
+    std::istringstream in{replies};
+    NullBuffer sink;
+    std::ostream out{&sink};
+    micro_mouse::StreamBackend backend{in, out};
+    const std::string text{"42"};
+
+    const auto session = [&](int count) {
+        for (int i{0}; i < count; ++i) {
+            const int x{i % 16};
+            backend.wall_front();
+            backend.wall_left();
+            backend.wall_right();
+            backend.move_forward(1);
+            backend.turn_right();
+            backend.maze_width();
+            backend.set_color(x, 12, 'G');
+            backend.set_text(x, 12, text);
+            backend.set_wall(x, 12, 'n');
+            backend.clear_color(x, 12);
+        }
+    };
+    // One round warms up the streams and the write buffer
+    session(1);
+    backend.reset_stats();
+    const std::size_t before{allocation_count};
+    session(rounds);
+    const std::size_t allocations{allocation_count - before};
+
+    std::cout << "commands,round_trips,allocations\n"
+              << backend.get_stats().commands << ','
+              << backend.get_stats().round_trips << ',' << allocations << '\n';
+    return allocations == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Speed of the protocol in one framing
+ */
+struct FramingSpeed {
+    std::size_t commands{0};
+    double seconds{0.0};
+    double client_seconds{0.0};
+    double server_seconds{0.0};
+};
+
+/**
+ * @brief Time a scripted protocol session in one framing
+ *
+ * A mix of queries, motions and display updates close to the alloc check
+ * goes to a MazeSimulator through a LoopbackLink and a ProtocolServer.
+ * @return Commands sent, wall time, and the client and server CPU time
+ */
+FramingSpeed time_framing(const micro_mouse::MazeLayout& layout, bool binary,
+                          int commands) {
+    micro_mouse::MazeSimulator simulator{layout};
+    micro_mouse::ProtocolServer server{simulator};
+    server.set_binary_offer(binary);
+    micro_mouse::LoopbackLink link{server};
+    micro_mouse::StreamBackend backend{link.client_in(), link.client_out()};
+    backend.set_binary_framing(binary);
+    const std::string text{"42"};
+    const int width{backend.maze_width()};
+    if (backend.is_binary() != binary) {
+        throw std::runtime_error{"framing not negotiated"};
+    }
+    backend.reset_stats();
+
+    constexpr int pattern_length{10};
+    const double server_start{link.get_server_seconds()};
+    const double cpu_start{micro_mouse::thread_cpu_seconds()};
+    const auto start = std::chrono::steady_clock::now();
+    for (int i{0}; i < commands / pattern_length; ++i) {
+        const int x{i % width};
+        const bool blocked{backend.wall_front()};
+        backend.wall_left();
+        backend.wall_right();
+        // Wander without crashing, which mms would report on every move
+        if (blocked) {
+            backend.turn_right();
+        } else {
+            backend.move_forward(1);
+        }
+        backend.maze_height();
+        backend.was_reset();
+        backend.set_color(x, 1, 'G');
+        backend.set_text(x, 1, text);
+        backend.set_wall(x, 1, 'n');
+        backend.clear_color(x, 1);
+    }
+    backend.flush();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    FramingSpeed speed;
+    speed.commands = backend.get_stats().commands;
+    speed.seconds = elapsed.count();
+    speed.server_seconds = link.get_server_seconds() - server_start;
+    speed.client_seconds =
+        micro_mouse::thread_cpu_seconds() - cpu_start - speed.server_seconds;
+    return speed;
+}
+
+/**
+ * @brief Compare the text protocol with the binary framing
+ * @param file Maze file
+ * @param commands Commands per framing
+ * @return Process exit status
+ */
+int bench_framing(const std::string& file, int commands) {
+    const auto layout = micro_mouse::load_maze_file(file);
+    std::cout << "framing,commands,seconds,commands_per_s,client_ns_per_command,"
+                 "server_ns_per_command\n";
+    for (const bool binary : {false, true}) {
+        const auto speed = time_framing(layout, binary, commands);
+        const auto count = static_cast<double>(speed.commands);
+        std::cout << (binary ? "binary" : "text") << ',' << speed.commands << ','
+                  << speed.seconds << ',' << count / speed.seconds << ','
+                  << speed.client_seconds / count * 1e9 << ','
+                  << speed.server_seconds / count * 1e9 << '\n';
+    }
+    return 0;
+}
+
+/**
+ * @brief Compare a cold run with a warm start from a learned map
+ *
+ * Solves the maze once with an empty memory file, times loading the saved
+ * map, then runs again from it.
+ * @param file Maze file
+ * @return Process exit status, non-zero if the warm start was not taken
+ */
+int bench_memory(const std::string& file) {
+    const std::string memory_file{
+        (std::filesystem::temp_directory_path() / "rwa4_bench_memory.bin").string()};
+    std::filesystem::remove(memory_file);
+    micro_mouse::MazeSimulator simulator{micro_mouse::load_maze_file(file)};
+    const auto& layout = simulator.get_layout();
+    const int max_moves{4 * layout.width * layout.height};
+
+    const auto run = [&] {
+        simulator.restart();
+        micro_mouse::MazeSession session{simulator};
+        const auto result =
+            micro_mouse::run_mouse_with_memory(session, false, max_moves, memory_file);
+        return std::make_pair(result, simulator.get_run_stats().moves);
+    };
+    const auto [cold, cold_moves] = run();
+
+    constexpr int repetitions{10000};
+    const auto start = std::chrono::steady_clock::now();
+    int loaded{0};
+    for (int i{0}; i < repetitions; ++i) {
+        loaded += micro_mouse::load_learned_maze(memory_file, layout.width,
+                                                 layout.height) ? 1 : 0;
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const auto [warm, warm_moves] = run();
+    std::filesystem::remove(memory_file);
+    std::cout << "maze,cold_moves,warm_moves,warm_start,load_us\n"
+              << file << ',' << cold_moves << ',' << warm_moves << ','
+              << (warm.warm_start ? 1 : 0) << ',' << elapsed.count() / repetitions
+              << '\n';
+    return cold.reached_center && warm.warm_start && loaded == repetitions ? 0 : 1;
+}
+
+/**
+ * @brief Press the reset button at every point of the runs of one solver
+ *
+ * A run without a press gives the number of cells travelled, explorations
+ * and speed run together. One run per cell then presses the button once
+ * the mouse has travelled that far, checking with every motion as in mms.
+ * Prints one row: the presses, the runs that reached the center, and those
+ * that crashed, with the first press that crashed.
+ * @return false if a run crashed, or missed the center when the run
+ * without a press reaches it
+ */
+bool sweep_resets(const micro_mouse::MazeLayout& layout, std::string_view name,
+                  micro_mouse::Exploration exploration,
+                  micro_mouse::Explorer explorer) {
+    const int max_moves{4 * layout.width * layout.height};
+    const auto run = [&](int press_after) {
+        micro_mouse::MazeSimulator simulator{layout};
+        if (press_after > 0) {
+            simulator.schedule_reset(press_after);
+        }
+        micro_mouse::MazeSession session{simulator};
+        session.set_reset_policy({1, std::chrono::milliseconds{0}, true});
+        const auto result =
+            micro_mouse::run_mouse(session, false, max_moves, false, exploration, explorer);
+        return std::pair{result.reached_center, simulator.get_run_stats().moves};
+    };
+    const auto [reaches_center, cells] = run(0);
+    int solved{0};
+    int crashed{0};
+    int first_crash{0};
+    for (int press_after{1}; press_after <= cells; ++press_after) {
+        try {
+            solved += run(press_after).first ? 1 : 0;
+        } catch (const std::exception& e) {
+            if (crashed++ == 0) {
+                first_crash = press_after;
+                std::cerr << name << ", reset after " << press_after
+                          << " cells: " << e.what() << '\n';
+            }
+        }
+    }
+    std::cout << name << ',' << cells << ',' << solved << ',' << crashed << ','
+              << first_crash << '\n';
+    return crashed == 0 && (!reaches_center || solved == cells);
+}
+
+/**
+ * @brief Round-trips of one exploration under several reset policies
+ *
+ * Runs the mouse through the text protocol, as run_maze() does, with the
+ * reset button pressed after @p press_after cells if it is positive. Then
+ * sweeps the press over every cell of the runs of each solver, and of
+ * the exploration that proves the shortest route (see sweep_resets()).
+ * @return Process exit status, non-zero if a run missed the center
+ */
+int bench_reset(const std::string& file, int press_after) {
+    struct Case {
+        const char* name;
+        micro_mouse::ResetPolicy policy;
+    };
+    const Case cases[]{
+        {"never", {}},
+        {"every_motion_separate", {1, std::chrono::milliseconds{0}, false}},
+        {"every_motion", {1, std::chrono::milliseconds{0}, true}},
+        {"every_4_motions", {4, std::chrono::milliseconds{0}, true}},
+        {"every_16_motions", {16, std::chrono::milliseconds{0}, true}},
+        {"every_1_ms", {0, std::chrono::milliseconds{1}, true}},
+    };
+    std::cout << "policy,solved,moves,commands,round_trips,checks,resets\n";
+    bool ok{true};
+    for (const auto& c : cases) {
+        micro_mouse::MazeSimulator simulator{micro_mouse::load_maze_file(file)};
+        if (press_after > 0) {
+            simulator.schedule_reset(press_after);
+        }
+        micro_mouse::ProtocolServer server{simulator};
+        micro_mouse::LoopbackLink link{server};
+        micro_mouse::StreamBackend client{link.client_in(), link.client_out()};
+        micro_mouse::MazeSession session{client};
+        session.set_reset_policy(c.policy);
+        const auto& layout = simulator.get_layout();
+        const auto result =
+            micro_mouse::run_mouse(session, false, 4 * layout.width * layout.height);
+        session.flush();
+        const auto stats = client.get_stats();
+        std::cout << c.name << ',' << (result.reached_center ? 1 : 0) << ','
+                  << simulator.get_run_stats().moves << ',' << stats.commands << ','
+                  << stats.round_trips << ',' << session.get_reset_stats().checks
+                  << ',' << session.get_reset_stats().resets << '\n';
+        ok = ok && result.reached_center;
+    }
+
+    const auto layout = micro_mouse::load_maze_file(file);
+    std::cout << "\nsolver,presses,solved,crashed,first_crash\n";
+    for (const auto& solver : micro_mouse::solver_registry()) {
+        ok = sweep_resets(layout, solver.name, micro_mouse::Exploration::TO_CENTER,
+                          solver.explore) && ok;
+    }
+    ok = sweep_resets(layout, "prove-shortest", micro_mouse::Exploration::PROVE_SHORTEST,
+                      micro_mouse::run_flood_fill) && ok;
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Time a maze's walls being discovered by one kind of distance field
+ *
+ * Each pass floods an empty maze, then reports every interior wall of the
+ * maze, row by row, as exploration would, and repairs after each.
+ * @param layout Maze whose walls are reported
+ * @param passes Number of passes
+ * @param fresh Resets the field and its map to the empty maze
+ * @param report Records one wall and repairs the field
+ * @return Average microseconds per pass
+ */
+template <class Fresh, class Report>
+double time_discovery(const micro_mouse::MazeLayout& layout, int passes,
+                      Fresh&& fresh, Report&& report) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass{0}; pass < passes; ++pass) {
+        fresh();
+        for (int y{0}; y < layout.height; ++y) {
+            for (int x{0}; x < layout.width; ++x) {
+                if (x + 1 < layout.width &&
+                    layout.has_wall(x, y, micro_mouse::Direction::EAST)) {
+                    report(x, y, micro_mouse::Direction::EAST);
+                }
+                if (y + 1 < layout.height &&
+                    layout.has_wall(x, y, micro_mouse::Direction::NORTH)) {
+                    report(x, y, micro_mouse::Direction::NORTH);
+                }
+            }
+        }
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / passes;
+}
+
+/**
+ * @brief Compare the dynamic and the compile-time sized flood fill
+ * @tparam W Columns of the static field
+ * @tparam H Rows of the static field
+ * @return false if the two fields end up different
+ */
+template <int W, int H>
+bool compare_flood_fills(const std::string& name, const micro_mouse::MazeLayout& layout) {
+    constexpr int passes{2000};
+    std::optional<micro_mouse::WallMap> map;
+    std::optional<micro_mouse::FloodFill> dynamic_field;
+    const double dynamic_us{time_discovery(
+        layout, passes,
+        [&] {
+            dynamic_field.reset();
+            map.emplace(W, H);
+            dynamic_field.emplace(*map);
+        },
+        [&](int x, int y, micro_mouse::Direction d) {
+            map->set_wall(x, y, d, true);
+            dynamic_field->add_wall(x, y, d);
+        })};
+    micro_mouse::StaticFloodFill<W, H> static_field;
+    const double static_us{time_discovery(
+        layout, passes, [&] { static_field = micro_mouse::StaticFloodFill<W, H>{}; },
+        [&](int x, int y, micro_mouse::Direction d) { static_field.add_wall(x, y, d); })};
+
+    bool same{true};
+    for (int y{0}; y < H; ++y) {
+        for (int x{0}; x < W; ++x) {
+            same = same && dynamic_field->distance(x, y) == static_field.distance(x, y);
+        }
+    }
+    std::cout << name << ',' << W << 'x' << H << ',' << dynamic_us << ',' << static_us
+              << ',' << dynamic_us / static_us << ',' << (same ? "ok" : "MISMATCH")
+              << '\n';
+    return same;
+}
+
+/**
+ * @brief Compare the flood fills on the 16x16 and 32x32 mazes given
+ * @return Process exit status, non-zero if the fields disagree
+ */
+int bench_static(const std::vector<std::string>& files) {
+    std::cout << "maze,size,dynamic_us,static_us,speedup,check\n";
+    bool ok{true};
+    for (const auto& file : files) {
+        const auto layout = micro_mouse::load_maze_file(file);
+        if (layout.width == 16 && layout.height == 16) {
+            ok = compare_flood_fills<16, 16>(file, layout) && ok;
+        } else if (layout.width == 32 && layout.height == 32) {
+            ok = compare_flood_fills<32, 32>(file, layout) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Count the known edges of a map that disagree with the maze
+ */
+int count_wrong_edges(const micro_mouse::WallMap& map,
+                      const micro_mouse::MazeLayout& layout) {
+    int wrong{0};
+    for (int y{0}; y < layout.height; ++y) {
+        for (int x{0}; x < layout.width; ++x) {
+            for (const auto d : {micro_mouse::Direction::NORTH, micro_mouse::Direction::EAST}) {
+                if (map.is_known(x, y, d) && map.has_wall(x, y, d) != layout.has_wall(x, y, d)) {
+                    ++wrong;
+                }
+            }
+        }
+    }
+    return wrong;
+}
+
+/**
+ * @brief Compare the exploration with and without the maze rules
+ *
+ * Explores each maze twice to the center, the second time deducing edges
+ * from the rules of official mazes, and checks every deduction against
+ * the maze. On a maze that breaks the rules, a wrong opening can send the
+ * mouse into a wall: the run stops there and its row is still printed,
+ * with the wrong deductions made so far and the crash.
+ * @return Process exit status, non-zero if a run missed the center or
+ * crashed, or a deduction was wrong
+ */
+int bench_rules(const std::vector<std::string>& files) {
+    std::cout << "maze,cells,cells_rules,moves,moves_rules,queries,queries_rules,"
+                 "inferred,pegs,center,start,dead_ends,wrong,crashed\n";
+    bool ok{true};
+    for (const auto& file : files) {
+        micro_mouse::MazeSimulator simulator{micro_mouse::load_maze_file(file)};
+        const auto& layout = simulator.get_layout();
+        struct Outcome {
+            micro_mouse::RunResult result;
+            int moves;
+            int wrong;
+            micro_mouse::SensingStats sensing;
+            micro_mouse::InferenceStats inference;
+            bool crashed;
+        };
+        const auto explore = [&](bool rules) {
+            simulator.restart();
+            micro_mouse::MazeSession session{simulator};
+            micro_mouse::Mouse mouse{session};
+            if (rules) {
+                mouse.use_maze_rules();
+            }
+            micro_mouse::RunResult result;
+            bool crashed{false};
+            try {
+                result = micro_mouse::run_flood_fill(mouse, false,
+                                                     4 * layout.width * layout.height);
+            } catch (const std::exception& e) {
+                std::cerr << file << ": " << e.what() << '\n';
+                result.cells_explored = static_cast<int>(mouse.get_map().visited_count());
+                crashed = true;
+            }
+            return Outcome{result,
+                           simulator.get_run_stats().moves,
+                           count_wrong_edges(mouse.get_map(), layout),
+                           mouse.get_sensing_stats(),
+                           mouse.get_inference_stats(),
+                           crashed};
+        };
+        const auto plain = explore(false);
+        const auto ruled = explore(true);
+        const auto& inferred = ruled.inference;
+        std::cout << file << ',' << plain.result.cells_explored << ','
+                  << ruled.result.cells_explored << ',' << plain.moves << ','
+                  << ruled.moves << ',' << plain.sensing.queries << ','
+                  << ruled.sensing.queries << ',' << inferred.total() << ','
+                  << inferred.pegs << ',' << inferred.center << ',' << inferred.start
+                  << ',' << inferred.dead_ends << ',' << ruled.wrong << ','
+                  << (plain.crashed || ruled.crashed ? 1 : 0) << '\n';
+        ok = ok && plain.result.reached_center && ruled.result.reached_center &&
+             ruled.wrong == 0 && !plain.crashed && !ruled.crashed;
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Compare exploring to the center with exploring until the shortest
+ * route is proven
+ *
+ * Runs each maze to the center with the flood fill, then with the two-bound
+ * planner, both followed by the speed run. A complete map is the other way
+ * to know the shortest route, so the cells the two-bound planner saves are
+ * counted against the cells reachable from the start.
+ * @return Process exit status, non-zero if a run failed or the two-bound
+ * planner stopped on a route longer than the shortest one
+ */
+int bench_bounds(const std::vector<std::string>& files) {
+    std::cout << "maze,reachable,shortest,cells_flood,cells_bound,cells_saved,"
+                 "route_flood,route_bound,moves_flood,moves_bound,run_time_flood,"
+                 "run_time_bound\n";
+    bool ok{true};
+    long reachable_total{0};
+    long flood_total{0};
+    long bound_total{0};
+    for (const auto& file : files) {
+        micro_mouse::MazeSimulator simulator{micro_mouse::load_maze_file(file)};
+        const auto& layout = simulator.get_layout();
+        const auto full = micro_mouse::make_wall_map(layout);
+        std::vector<int> from_start;
+        micro_mouse::compute_distances(full, micro_mouse::single_cell_goal(layout.height, 0, 0),
+                                       false, from_start);
+        const auto reachable = std::count_if(from_start.begin(), from_start.end(), [&](int d) {
+            return d < layout.width * layout.height;
+        });
+        const int shortest{micro_mouse::path_bounds(full).pessimistic};
+        const auto run = [&](micro_mouse::Exploration exploration) {
+            simulator.restart();
+            micro_mouse::MazeSession session{simulator};
+            auto result = micro_mouse::run_mouse(session, false,
+                                                 4 * layout.width * layout.height,
+                                                 false, exploration);
+            return std::make_pair(result, simulator.get_run_stats().moves);
+        };
+        const auto [flood, flood_moves] = run(micro_mouse::Exploration::TO_CENTER);
+        const auto [bound, bound_moves] = run(micro_mouse::Exploration::PROVE_SHORTEST);
+        std::cout << file << ',' << reachable << ',' << shortest << ','
+                  << flood.cells_explored << ',' << bound.cells_explored << ','
+                  << reachable - bound.cells_explored << ','
+                  << flood.bounds.pessimistic << ',' << bound.bounds.pessimistic << ','
+                  << flood_moves << ',' << bound_moves << ',' << flood.speed_run.time
+                  << ',' << bound.speed_run.time << '\n';
+        ok = ok && flood.reached_center && bound.reached_center &&
+             bound.bounds.pessimistic == shortest;
+        reachable_total += reachable;
+        flood_total += flood.cells_explored;
+        bound_total += bound.cells_explored;
+    }
+    std::cerr << "cells explored: " << flood_total << " to the center, " << bound_total
+              << " to prove the shortest route, " << reachable_total
+              << " reachable (" << reachable_total - bound_total << " saved)\n";
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Stream buffer over one end of a pipe
+ */
+class PipeBuffer : public std::streambuf {
+public:
+    explicit PipeBuffer(int fd) : fd_{fd} {
+        setg(input_.data(), input_.data(), input_.data());
+        setp(output_.data(), output_.data() + output_.size());
+    }
+
+    ~PipeBuffer() override { close(); }
+
+    PipeBuffer(const PipeBuffer&) = delete;
+    PipeBuffer& operator=(const PipeBuffer&) = delete;
+
+    // Send what is buffered and close the descriptor; the reader sees the
+    // end of the stream
+    void close() {
+        if (fd_ >= 0) {
+            sync();
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+protected:
+    int_type underflow() override {
+        const ssize_t count{::read(fd_, input_.data(), input_.size())};
+        if (count <= 0) {
+            return traits_type::eof();
+        }
+        setg(input_.data(), input_.data(), input_.data() + count);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    int_type overflow(int_type c) override {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        for (const char* p{pbase()}; p < pptr();) {
+            const ssize_t count{::write(fd_, p, static_cast<std::size_t>(pptr() - p))};
+            if (count <= 0) {
+                return -1;
+            }
+            p += count;
+        }
+        setp(output_.data(), output_.data() + output_.size());
+        return 0;
+    }
+
+private:
+    int fd_;
+    std::array<char, 4096> input_{};
+    std::array<char, 4096> output_{};
+};
+
+/**
+ * @brief Answer the text protocol over a pair of pipes, slowly
+ *
+ * Stands in for mms: every reply is held back by @p latency, as if the
+ * simulator were animating the mouse. Returns when the client closes its
+ * end, and closes the reply pipe on the way out.
+ */
+void serve_slowly(const micro_mouse::MazeLayout& layout, int in_fd, int out_fd,
+                  std::chrono::microseconds latency) {
+    micro_mouse::MazeSimulator simulator{layout};
+    micro_mouse::ProtocolServer server{simulator};
+    PipeBuffer in_buffer{in_fd};
+    PipeBuffer out_buffer{out_fd};
+    std::istream in{&in_buffer};
+    std::ostream out{&out_buffer};
+    std::string line;
+    std::string reply;
+    while (std::getline(in, line)) {
+        if (server.handle(line, reply)) {
+            std::this_thread::sleep_for(latency);
+            out << reply << '\n' << std::flush;
+        }
+    }
+}
+
+/**
+ * @brief Run the mouse against a slow simulator thread over real pipes
+ * @param layout Maze
+ * @param latency Time the simulator takes per reply
+ * @param overlap Send each step at once and plan while it is in flight
+ * @return Process exit status, non-zero if the center was missed
+ */
+int run_over_pipes(const micro_mouse::MazeLayout& layout,
+                   std::chrono::microseconds latency, bool overlap) {
+    int to_server[2];
+    int to_client[2];
+    if (::pipe(to_server) != 0 || ::pipe(to_client) != 0) {
+        std::cerr << "cannot create pipes\n";
+        return 1;
+    }
+    std::thread simulator{serve_slowly, std::cref(layout), to_server[0],
+                          to_client[1], latency};
+    micro_mouse::RunResult result;
+    micro_mouse::ChannelStats stats;
+    std::chrono::duration<double> elapsed{};
+    {
+        PipeBuffer in_buffer{to_client[0]};
+        PipeBuffer out_buffer{to_server[1]};
+        std::istream in{&in_buffer};
+        std::ostream out{&out_buffer};
+        micro_mouse::StreamBackend client{in, out};
+        client.set_step_overlap(overlap);
+        client.start_reader();
+        micro_mouse::MazeSession session{client};
+        const auto start = std::chrono::steady_clock::now();
+        result = micro_mouse::run_mouse(session, false, 4 * layout.width * layout.height);
+        session.flush();
+        elapsed = std::chrono::steady_clock::now() - start;
+        stats = client.get_stats();
+        // Lets the simulator finish, which ends the replies the reader waits for
+        out_buffer.close();
+    }
+    simulator.join();
+    std::cout << (overlap ? "overlapped" : "sequential") << ','
+              << (result.reached_center ? 1 : 0) << ',' << stats.round_trips << ','
+              << elapsed.count() * 1e3 << ',' << result.overlap.steps << ','
+              << result.overlap.planning_seconds * 1e6 << ','
+              << result.overlap.hidden_fraction() << '\n';
+    return result.reached_center ? 0 : 1;
+}
+
+/**
+ * @brief Compare sequential and overlapped steps against a slow simulator
+ *
+ * The overlapped run plans each move while the step before it is in
+ * flight and reports how much of that planning the simulator latency hid.
+ * @return Process exit status, non-zero if a run missed the center
+ */
+int bench_overlap(const std::string& file, std::chrono::microseconds latency) {
+    const auto layout = micro_mouse::load_maze_file(file);
+    std::cout << "mode,solved,round_trips,wall_ms,planned_steps,planning_us,"
+                 "hidden_fraction\n";
+    const int sequential{run_over_pipes(layout, latency, false)};
+    const int overlapped{run_over_pipes(layout, latency, true)};
+    return sequential != 0 ? sequential : overlapped;
+}
+
+/**
+ * @brief Parse the number given to a command
+ * @param text Argument
+ * @return The number
+ * @throw std::invalid_argument if @p text is not a whole number that fits
+ * in an int
+ */
+int parse_number(const std::string& text) {
+    int value{0};
+    const char* end{text.data() + text.size()};
+    const auto [last, error] = std::from_chars(text.data(), end, value);
+    if (text.empty() || error != std::errc{} || last != end) {
+        throw std::invalid_argument{"expected a number, got '" + text + "'"};
+    }
+    return value;
+}
+
+/**
+ * @brief Run the command named by the first argument
+ * @param args Arguments, without the program name
+ * @return Process exit status, empty if no command matches @p args
+ * @throw std::invalid_argument on a malformed number or an unknown solver
+ */
+std::optional<int> run_command(const std::vector<std::string>& args) {
+    // Usage: rwa4_bench corpus <maze directory> [--json] [--jobs <n>] [--binary]
+    //                          [--solver <name>]
+    //        rwa4_bench solvers <maze directory> [--jobs <n>]
+    //        rwa4_bench kernels <maze file>...
+    //        rwa4_bench goals <maze file>...
+    //        rwa4_bench load [--passes <n>] <maze file>...
+    //        rwa4_bench alloc [commands]
+    //        rwa4_bench framing <maze file> [commands]
+    //        rwa4_bench memory <maze file>
+    //        rwa4_bench reset <maze file> [press after n cells]
+    //        rwa4_bench static <maze file>...
+    //        rwa4_bench overlap <maze file> [latency us]
+    //        rwa4_bench rules <maze file>...
+    //        rwa4_bench bounds <maze file>...
+    if (args.size() >= 2 && args[0] == "corpus") {
+        bool json{false};
+        bool binary{false};
+        micro_mouse::Explorer explorer{micro_mouse::run_flood_fill};
+        unsigned jobs{std::max(1U, std::thread::hardware_concurrency())};
+        for (std::size_t i{2}; i < args.size(); ++i) {
+            if (args[i] == "--json") {
+                json = true;
+            } else if (args[i] == "--binary") {
+                binary = true;
+            } else if (args[i] == "--solver" && i + 1 < args.size()) {
+                explorer = micro_mouse::find_solver(args[++i]);
+            } else if (args[i] == "--jobs" && i + 1 < args.size()) {
+                jobs = static_cast<unsigned>(std::max(1, parse_number(args[++i])));
+            }
+        }
+        return bench_corpus(args[1], json, jobs, binary, explorer);
+    }
+    if (args.size() >= 2 && args[0] == "solvers") {
+        unsigned jobs{std::max(1U, std::thread::hardware_concurrency())};
+        if (args.size() >= 4 && args[2] == "--jobs") {
+            jobs = static_cast<unsigned>(std::max(1, parse_number(args[3])));
+        }
+        return bench_solvers(args[1], jobs);
+    }
+    if (!args.empty() && args[0] == "kernels") {
+        return bench_kernels({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "goals") {
+        return bench_goals({args.begin() + 1, args.end()});
+    }
+    if (args.size() >= 2 && args[0] == "load") {
+        const bool passes_given{args.size() >= 4 && args[1] == "--passes"};
+        return bench_load({args.begin() + (passes_given ? 3 : 1), args.end()},
+                          passes_given ? parse_number(args[2]) : 100);
+    }
+    if (!args.empty() && args[0] == "alloc") {
+        return bench_allocations(args.size() > 1 ? parse_number(args[1]) : 10000);
+    }
+    if (args.size() >= 2 && args[0] == "framing") {
+        return bench_framing(args[1], args.size() > 2 ? parse_number(args[2]) : 1000000);
+    }
+    if (args.size() == 2 && args[0] == "memory") {
+        return bench_memory(args[1]);
+    }
+    if (args.size() >= 2 && args[0] == "reset") {
+        return bench_reset(args[1], args.size() > 2 ? parse_number(args[2]) : 0);
+    }
+    if (!args.empty() && args[0] == "static") {
+        return bench_static({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "rules") {
+        return bench_rules({args.begin() + 1, args.end()});
+    }
+    if (!args.empty() && args[0] == "bounds") {
+        return bench_bounds({args.begin() + 1, args.end()});
+    }
+    if (args.size() >= 2 && args[0] == "overlap") {
+        return bench_overlap(args[1], std::chrono::microseconds{
+                                          args.size() > 2 ? parse_number(args[2]) : 100});
+    }
+    return std::nullopt;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (const auto status = run_command(args)) {
+            return *status;
+        }
+    } catch (const std::invalid_argument& e) {
+        // Malformed number, unknown solver, or a maze file that breaks the
+        // format
+        std::cerr << e.what() << '\n';
+    }
+    std::cerr << "usage: rwa4_bench corpus <maze directory> [--json] [--jobs <n>] [--binary]\n"
+                 "                         [--solver <name>]\n"
+                 "       rwa4_bench solvers <maze directory> [--jobs <n>]\n"
+                 "       rwa4_bench kernels <maze file>...\n"
+                 "       rwa4_bench goals <maze file>...\n"
+                 "       rwa4_bench load [--passes <n>] <maze file>...\n"
+                 "       rwa4_bench alloc [commands]\n"
+                 "       rwa4_bench framing <maze file> [commands]\n"
+                 "       rwa4_bench memory <maze file>\n"
+                 "       rwa4_bench reset <maze file> [press after n cells]\n"
+                 "       rwa4_bench static <maze file>...\n"
+                 "       rwa4_bench overlap <maze file> [latency us]\n"
+                 "       rwa4_bench rules <maze file>...\n"
+                 "       rwa4_bench bounds <maze file>...\n";
+    return 2;
+}
@@ -0,0 +1,69 @@
+#include "bucket_queue.hpp"
+
+#include <algorithm>
+
+micro_mouse::BucketQueue::BucketQueue(std::size_t items, int max_key)
+    : heads_(static_cast<std::size_t>(max_key) + 1, -1),
+      next_(items, -1),
+      previous_(items, -1),
+      keys_(items, -1),
+      lowest_{max_key + 1} {}
+
+void micro_mouse::BucketQueue::push(int item, int key) {
+    const auto i = static_cast<std::size_t>(item);
+    if (keys_[i] == key) {
+        return;
+    }
+    erase(item);
+    auto& head = heads_[static_cast<std::size_t>(key)];
+    next_[i] = head;
+    previous_[i] = -1;
+    if (head >= 0) {
+        previous_[static_cast<std::size_t>(head)] = item;
+    }
+    head = item;
+    keys_[i] = key;
+    lowest_ = std::min(lowest_, key);
+    ++size_;
+}
+
+void micro_mouse::BucketQueue::erase(int item) {
+    const auto i = static_cast<std::size_t>(item);
+    if (keys_[i] < 0) {
+        return;
+    }
+    if (previous_[i] >= 0) {
+        next_[static_cast<std::size_t>(previous_[i])] = next_[i];
+    } else {
+        heads_[static_cast<std::size_t>(keys_[i])] = next_[i];
+    }
+    if (next_[i] >= 0) {
+        previous_[static_cast<std::size_t>(next_[i])] = previous_[i];
+    }
+    keys_[i] = -1;
+    --size_;
+}
+
+int micro_mouse::BucketQueue::first() noexcept {
+    if (size_ == 0) {
+        return -1;
+    }
+    // Buckets emptied since the last call are skipped once and for all
+    while (heads_[static_cast<std::size_t>(lowest_)] < 0) {
+        ++lowest_;
+    }
+    return heads_[static_cast<std::size_t>(lowest_)];
+}
+
+int micro_mouse::BucketQueue::next(int item) const noexcept {
+    const auto i = static_cast<std::size_t>(item);
+    if (next_[i] >= 0) {
+        return next_[i];
+    }
+    for (auto key = static_cast<std::size_t>(keys_[i]) + 1; key < heads_.size(); ++key) {
+        if (heads_[key] >= 0) {
+            return heads_[key];
+        }
+    }
+    return -1;
+}
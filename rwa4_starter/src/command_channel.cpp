@@ -0,0 +1,199 @@
+#include "command_channel.hpp"
+
+#include <cctype>
+#include <iostream>
+
+micro_mouse::CommandChannel::CommandChannel(std::istream& in, std::ostream& out)
+    : in_{in}, out_{out} {
+    // A 16x16 repaint is a few kilobytes of text; avoid regrowing the buffer.
+    write_buffer_.reserve(8192);
+}
+
+micro_mouse::CommandChannel::~CommandChannel() {
+    flush();
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+}
+
+void micro_mouse::CommandChannel::post(std::string_view line) {
+    write_buffer_.append(line);
+    if (!binary_) {
+        write_buffer_.push_back('\n');
+    }
+    ++stats_.commands;
+}
+
+std::string_view micro_mouse::CommandChannel::request(std::string_view line) {
+    post(line);
+    flush();
+    ++stats_.round_trips;
+    if (deferred_pending_) {
+        read_deferred_reply();
+    }
+    read_reply();
+    return first_token({reply_.data(), reply_size_});
+}
+
+void micro_mouse::CommandChannel::defer_request(std::string_view line) {
+    post(line);
+    deferred_pending_ = true;
+    ++outstanding_;
+}
+
+std::string_view micro_mouse::CommandChannel::take_deferred_reply() {
+    if (deferred_pending_) {
+        flush();
+        ++stats_.round_trips;
+        read_deferred_reply();
+    }
+    return first_token({deferred_reply_.data(), deferred_size_});
+}
+
+void micro_mouse::CommandChannel::send(std::string_view line) {
+    post(line);
+    batch_waiting_ = true;
+    ++outstanding_;
+}
+
+std::string_view micro_mouse::CommandChannel::receive() {
+    if (batch_waiting_) {
+        flush();
+        ++stats_.round_trips;
+        batch_waiting_ = false;
+    }
+    if (deferred_pending_) {
+        read_deferred_reply();
+    }
+    read_reply();
+    --outstanding_;
+    return first_token({reply_.data(), reply_size_});
+}
+
+bool micro_mouse::CommandChannel::replies_arrived() {
+    if (outstanding_ == 0) {
+        return true;
+    }
+    if (!reader_.joinable()) {
+        return in_.rdbuf()->in_avail() > 0;
+    }
+    const std::lock_guard lock{arrived_mutex_};
+    return arrived_count_ >= outstanding_;
+}
+
+void micro_mouse::CommandChannel::start_reader() {
+    if (!reader_.joinable()) {
+        reader_ = std::thread{[this] { read_replies(); }};
+    }
+}
+
+void micro_mouse::CommandChannel::read_deferred_reply() {
+    read_reply();
+    deferred_reply_ = reply_;
+    deferred_size_ = reply_size_;
+    deferred_pending_ = false;
+    --outstanding_;
+}
+
+namespace {
+// Read the next non-empty line of @p in into @p line, cut to its capacity;
+// returns false once the stream has ended
+template <std::size_t N>
+bool read_line(std::istream& in, std::array<char, N>& line, std::size_t& size) {
+    size = 0;
+    std::streambuf* source = in.rdbuf();
+    using traits = std::char_traits<char>;
+    // Skip blank space, including the end of the previous line
+    auto c = source->sgetc();
+    while (!traits::eq_int_type(c, traits::eof()) &&
+           std::isspace(c) != 0) {
+        c = source->snextc();
+    }
+    while (!traits::eq_int_type(c, traits::eof()) && traits::to_char_type(c) != '\n') {
+        const char ch{traits::to_char_type(c)};
+        if (ch != '\r' && size < line.size()) {
+            line[size++] = ch;
+        }
+        c = source->snextc();
+    }
+    if (traits::eq_int_type(c, traits::eof())) {
+        in.setstate(std::ios::eofbit);
+        return size != 0;
+    }
+    // Take the newline, which is already buffered, so that a switch to
+    // binary frames does not read it as a reply byte
+    source->sbumpc();
+    return true;
+}
+}  // namespace
+
+std::string_view micro_mouse::CommandChannel::first_token(
+    std::string_view reply) const noexcept {
+    // A binary reply byte may well be the code of a space
+    return binary_ ? reply : reply.substr(0, reply.find(' '));
+}
+
+bool micro_mouse::CommandChannel::read_one(std::array<char, 64>& text,
+                                           std::size_t& size) {
+    if (!binary_) {
+        return read_line(in_, text, size);
+    }
+    // A binary reply is one byte, whatever its value
+    using traits = std::char_traits<char>;
+    const auto c = in_.rdbuf()->sbumpc();
+    if (traits::eq_int_type(c, traits::eof())) {
+        in_.setstate(std::ios::eofbit);
+        size = 0;
+        return false;
+    }
+    text[0] = traits::to_char_type(c);
+    size = 1;
+    return true;
+}
+
+void micro_mouse::CommandChannel::read_reply() {
+    if (!reader_.joinable()) {
+        read_one(reply_, reply_size_);
+        reply_time_ = std::chrono::steady_clock::now();
+        return;
+    }
+    std::unique_lock lock{arrived_mutex_};
+    arrived_ready_.wait(lock, [this] { return arrived_count_ > 0 || input_ended_; });
+    if (arrived_count_ == 0) {
+        reply_size_ = 0;
+        return;
+    }
+    const auto& arrived = arrived_[arrived_head_];
+    reply_ = arrived.text;
+    reply_size_ = arrived.size;
+    reply_time_ = arrived.time;
+    arrived_head_ = (arrived_head_ + 1) % arrived_.size();
+    --arrived_count_;
+    arrived_ready_.notify_all();
+}
+
+void micro_mouse::CommandChannel::read_replies() {
+    ArrivedReply reply;
+    while (read_one(reply.text, reply.size)) {
+        reply.time = std::chrono::steady_clock::now();
+        std::unique_lock lock{arrived_mutex_};
+        arrived_ready_.wait(lock, [this] { return arrived_count_ < arrived_.size(); });
+        arrived_[(arrived_head_ + arrived_count_) % arrived_.size()] = reply;
+        ++arrived_count_;
+        arrived_ready_.notify_all();
+    }
+    const std::lock_guard lock{arrived_mutex_};
+    input_ended_ = true;
+    arrived_ready_.notify_all();
+}
+
+void micro_mouse::CommandChannel::flush() {
+    if (write_buffer_.empty()) {
+        return;
+    }
+    out_.write(write_buffer_.data(),
+               static_cast<std::streamsize>(write_buffer_.size()));
+    out_.flush();
+    write_buffer_.clear();
+    ++stats_.flushes;
+}
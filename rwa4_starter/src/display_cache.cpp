@@ -0,0 +1,152 @@
+#include "display_cache.hpp"
+
+void micro_mouse::DisplayCache::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    const auto cells = static_cast<std::size_t>(width * height);
+    shown_color_.resize(cells, no_color);
+    wanted_color_.resize(cells, no_color);
+    shown_text_.resize(cells);
+    wanted_text_.resize(cells);
+    colors_shown_ = 0;
+    texts_shown_ = 0;
+    dirty_.assign(cells, false);
+    dirty_cells_.clear();
+}
+
+int micro_mouse::DisplayCache::cell_index(int x, int y) const noexcept {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+        return -1;
+    }
+    return y * width_ + x;
+}
+
+void micro_mouse::DisplayCache::set_color(MazeBackend& backend, int x, int y,
+                                          char color) {
+    ++stats_.requested;
+    const int cell{cell_index(x, y)};
+    if (cell < 0) {
+        ++stats_.sent;
+        backend.set_color(x, y, color);
+        return;
+    }
+    wanted_color_.set(static_cast<std::size_t>(cell), color);
+    update(backend, cell);
+}
+
+void micro_mouse::DisplayCache::clear_color(MazeBackend& backend, int x, int y) {
+    ++stats_.requested;
+    const int cell{cell_index(x, y)};
+    if (cell < 0) {
+        ++stats_.sent;
+        backend.clear_color(x, y);
+        return;
+    }
+    wanted_color_.set(static_cast<std::size_t>(cell), no_color);
+    update(backend, cell);
+}
+
+void micro_mouse::DisplayCache::clear_all_color(MazeBackend& backend) {
+    ++stats_.requested;
+    wanted_color_.clear();
+    if (colors_shown_ > 0 || !is_sized()) {
+        ++stats_.sent;
+        backend.clear_all_color();
+        shown_color_.clear();
+        colors_shown_ = 0;
+    }
+}
+
+void micro_mouse::DisplayCache::set_text(MazeBackend& backend, int x, int y,
+                                         const std::string& text) {
+    ++stats_.requested;
+    const int cell{cell_index(x, y)};
+    if (cell < 0) {
+        ++stats_.sent;
+        backend.set_text(x, y, text);
+        return;
+    }
+    wanted_text_.set(static_cast<std::size_t>(cell), text);
+    update(backend, cell);
+}
+
+void micro_mouse::DisplayCache::clear_text(MazeBackend& backend, int x, int y) {
+    ++stats_.requested;
+    const int cell{cell_index(x, y)};
+    if (cell < 0) {
+        ++stats_.sent;
+        backend.clear_text(x, y);
+        return;
+    }
+    wanted_text_.at(static_cast<std::size_t>(cell)).clear();
+    update(backend, cell);
+}
+
+void micro_mouse::DisplayCache::clear_all_text(MazeBackend& backend) {
+    ++stats_.requested;
+    wanted_text_.clear();
+    if (texts_shown_ > 0 || !is_sized()) {
+        ++stats_.sent;
+        backend.clear_all_text();
+        shown_text_.clear();
+        texts_shown_ = 0;
+    }
+}
+
+void micro_mouse::DisplayCache::update(MazeBackend& backend, int cell) {
+    if (interval_ == std::chrono::steady_clock::duration::zero()) {
+        send_cell(backend, cell);
+        return;
+    }
+    if (!dirty_[static_cast<std::size_t>(cell)]) {
+        dirty_[static_cast<std::size_t>(cell)] = true;
+        dirty_cells_.push_back(cell);
+    }
+}
+
+void micro_mouse::DisplayCache::send_cell(MazeBackend& backend, int cell) {
+    const auto i = static_cast<std::size_t>(cell);
+    const int x{cell % width_};
+    const int y{cell / width_};
+    const char wanted_color{wanted_color_.get(i)};
+    const char shown_color{shown_color_.get(i)};
+    if (wanted_color != shown_color) {
+        ++stats_.sent;
+        if (wanted_color == no_color) {
+            backend.clear_color(x, y);
+            --colors_shown_;
+        } else {
+            backend.set_color(x, y, wanted_color);
+            colors_shown_ += shown_color == no_color ? 1 : 0;
+        }
+        shown_color_.set(i, wanted_color);
+    }
+    const std::string& wanted_text{wanted_text_.get(i)};
+    if (wanted_text != shown_text_.get(i)) {
+        ++stats_.sent;
+        if (wanted_text.empty()) {
+            backend.clear_text(x, y);
+            --texts_shown_;
+        } else {
+            backend.set_text(x, y, wanted_text);
+            texts_shown_ += shown_text_.get(i).empty() ? 1 : 0;
+        }
+        shown_text_.set(i, wanted_text);
+    }
+}
+
+void micro_mouse::DisplayCache::flush(MazeBackend& backend, bool force) {
+    if (dirty_cells_.empty()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (!force && now - last_frame_ < interval_) {
+        return;
+    }
+    for (const int cell : dirty_cells_) {
+        dirty_[static_cast<std::size_t>(cell)] = false;
+        send_cell(backend, cell);
+    }
+    dirty_cells_.clear();
+    last_frame_ = now;
+}
@@ -0,0 +1,257 @@
+#include "distance_kernel.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+void micro_mouse::scalar_distances(const WallMap& map,
+                                   const std::vector<std::uint64_t>& seeds,
+                                   bool optimistic, std::vector<int>& distances) {
+    const int width{map.width()};
+    const int height{map.height()};
+    const int unreachable{width * height};
+    distances.assign(static_cast<std::size_t>(unreachable), unreachable);
+    std::queue<int> frontier;
+    for (int y{0}; y < height; ++y) {
+        for (int x{0}; x < width; ++x) {
+            if ((seeds[static_cast<std::size_t>(y)] >> x) & 1U) {
+                distances[static_cast<std::size_t>(y * width + x)] = 0;
+                frontier.push(y * width + x);
+            }
+        }
+    }
+    while (!frontier.empty()) {
+        const int cell{frontier.front()};
+        frontier.pop();
+        const int x{cell % width};
+        const int y{cell / width};
+        const int next{distances[static_cast<std::size_t>(cell)] + 1};
+        for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                             Direction::WEST}) {
+            const bool open{optimistic ? !map.has_wall(x, y, d) : map.is_open(x, y, d)};
+            if (!open) {
+                continue;
+            }
+            const int neighbour{(y + dy_of(d)) * width + x + dx_of(d)};
+            auto& distance = distances[static_cast<std::size_t>(neighbour)];
+            if (next < distance) {
+                distance = next;
+                frontier.push(neighbour);
+            }
+        }
+    }
+}
+
+void micro_mouse::wavefront_distances(const WallMap& map,
+                                      const std::vector<std::uint64_t>& seeds,
+                                      bool optimistic,
+                                      std::vector<int>& distances) {
+    const int width{map.width()};
+    const auto height = static_cast<std::size_t>(map.height());
+    const int unreachable{width * map.height()};
+    distances.assign(static_cast<std::size_t>(unreachable), unreachable);
+
+    std::vector<std::uint64_t> open_north(height);
+    std::vector<std::uint64_t> open_east(height);
+    for (std::size_t y{0}; y < height; ++y) {
+        open_north[y] = map.open_north(static_cast<int>(y), optimistic);
+        open_east[y] = map.open_east(static_cast<int>(y), optimistic);
+    }
+    std::vector<std::uint64_t> frontier(seeds.begin(), seeds.begin() + static_cast<std::ptrdiff_t>(height));
+    std::vector<std::uint64_t> reached{frontier};
+    std::vector<std::uint64_t> next(height);
+    const std::uint64_t row_mask{map.row_mask()};
+
+    int wave{0};
+    bool growing{true};
+    while (growing) {
+        // Label the cells first reached by this wave
+        for (std::size_t y{0}; y < height; ++y) {
+            for (std::uint64_t bits{frontier[y]}; bits != 0; bits &= bits - 1) {
+                const int x{__builtin_ctzll(bits)};
+                distances[y * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)] = wave;
+            }
+        }
+        ++wave;
+        growing = false;
+        for (std::size_t y{0}; y < height; ++y) {
+            const std::uint64_t f{frontier[y]};
+            // East: leave x through its east side. West: enter x - 1
+            // through the east side of x - 1.
+            std::uint64_t grown{((f & open_east[y]) << 1) | ((f >> 1) & open_east[y])};
+            if (y > 0) {
+                grown |= frontier[y - 1] & open_north[y - 1];
+            }
+            if (y + 1 < height) {
+                grown |= frontier[y + 1] & open_north[y];
+            }
+            next[y] = grown & ~reached[y] & row_mask;
+            growing = growing || next[y] != 0;
+        }
+        for (std::size_t y{0}; y < height; ++y) {
+            reached[y] |= next[y];
+        }
+        frontier.swap(next);
+    }
+}
+
+namespace {
+// Number of goal cells in the first height rows of seeds
+std::size_t count_goals(const std::vector<std::uint64_t>& seeds, int height) {
+    std::size_t goals{0};
+    for (int y{0}; y < height; ++y) {
+        goals += static_cast<std::size_t>(
+            __builtin_popcountll(seeds[static_cast<std::size_t>(y)]));
+    }
+    if (goals >= micro_mouse::no_goal) {
+        throw std::invalid_argument{"at most 255 goals have an id"};
+    }
+    return goals;
+}
+}  // namespace
+
+void micro_mouse::scalar_nearest_goals(const WallMap& map,
+                                       const std::vector<std::uint64_t>& seeds,
+                                       bool optimistic, std::vector<int>& distances,
+                                       std::vector<std::uint8_t>& nearest) {
+    const int width{map.width()};
+    const int height{map.height()};
+    const int unreachable{width * height};
+    count_goals(seeds, height);
+    distances.assign(static_cast<std::size_t>(unreachable), unreachable);
+    nearest.assign(static_cast<std::size_t>(unreachable), no_goal);
+    std::queue<int> frontier;
+    std::uint8_t goal{0};
+    for (int y{0}; y < height; ++y) {
+        for (int x{0}; x < width; ++x) {
+            if ((seeds[static_cast<std::size_t>(y)] >> x) & 1U) {
+                distances[static_cast<std::size_t>(y * width + x)] = 0;
+                nearest[static_cast<std::size_t>(y * width + x)] = goal++;
+                frontier.push(y * width + x);
+            }
+        }
+    }
+    while (!frontier.empty()) {
+        const int cell{frontier.front()};
+        frontier.pop();
+        const int x{cell % width};
+        const int y{cell / width};
+        const int next{distances[static_cast<std::size_t>(cell)] + 1};
+        const std::uint8_t label{nearest[static_cast<std::size_t>(cell)]};
+        for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                             Direction::WEST}) {
+            const bool open{optimistic ? !map.has_wall(x, y, d) : map.is_open(x, y, d)};
+            if (!open) {
+                continue;
+            }
+            const auto neighbour =
+                static_cast<std::size_t>((y + dy_of(d)) * width + x + dx_of(d));
+            if (next < distances[neighbour]) {
+                distances[neighbour] = next;
+                nearest[neighbour] = label;
+                frontier.push(static_cast<int>(neighbour));
+            } else if (next == distances[neighbour] && label < nearest[neighbour]) {
+                // Still queued behind this wave, so it passes the lower id on
+                nearest[neighbour] = label;
+            }
+        }
+    }
+}
+
+void micro_mouse::wavefront_nearest_goals(const WallMap& map,
+                                          const std::vector<std::uint64_t>& seeds,
+                                          bool optimistic, std::vector<int>& distances,
+                                          std::vector<std::uint8_t>& nearest) {
+    const int width{map.width()};
+    const auto height = static_cast<std::size_t>(map.height());
+    const int unreachable{width * map.height()};
+    const std::size_t goals{count_goals(seeds, map.height())};
+    distances.assign(static_cast<std::size_t>(unreachable), unreachable);
+    nearest.assign(static_cast<std::size_t>(unreachable), no_goal);
+
+    std::vector<std::uint64_t> open_north(height);
+    std::vector<std::uint64_t> open_east(height);
+    for (std::size_t y{0}; y < height; ++y) {
+        open_north[y] = map.open_north(static_cast<int>(y), optimistic);
+        open_east[y] = map.open_east(static_cast<int>(y), optimistic);
+    }
+    // Rows of the frontier of goal g at g * height, all zero outside the
+    // rows first[g] to last[g]; a maze corridor rarely spans many rows,
+    // so each goal only grows the few rows its wave occupies
+    std::vector<std::uint64_t> frontier(goals * height, 0);
+    std::vector<std::uint64_t> next(goals * height, 0);
+    std::vector<std::size_t> first(goals);
+    std::vector<std::size_t> last(goals);
+    std::vector<std::uint64_t> reached(seeds.begin(), seeds.begin() + static_cast<std::ptrdiff_t>(height));
+    std::size_t goal{0};
+    for (std::size_t y{0}; y < height; ++y) {
+        for (std::uint64_t bits{seeds[y]}; bits != 0; bits &= bits - 1) {
+            frontier[goal * height + y] = bits & (~bits + 1);
+            first[goal] = y;
+            last[goal] = y;
+            ++goal;
+        }
+    }
+    const std::uint64_t row_mask{map.row_mask()};
+
+    int wave{0};
+    bool growing{true};
+    while (growing) {
+        ++wave;
+        growing = false;
+        // Lower goals claim first, so they win the ties
+        for (std::size_t g{0}; g < goals; ++g) {
+            if (first[g] > last[g]) {
+                continue;
+            }
+            const auto* f = &frontier[g * height];
+            auto* n = &next[g * height];
+            const std::size_t low{first[g] > 0 ? first[g] - 1 : 0};
+            const std::size_t high{std::min(last[g] + 1, height - 1)};
+            std::size_t new_first{high + 1};
+            std::size_t new_last{0};
+            for (std::size_t y{low}; y <= high; ++y) {
+                // Label the cells the previous wave reached
+                for (std::uint64_t bits{f[y]}; bits != 0; bits &= bits - 1) {
+                    const auto cell = y * static_cast<std::size_t>(width) +
+                                      static_cast<std::size_t>(__builtin_ctzll(bits));
+                    distances[cell] = wave - 1;
+                    nearest[cell] = static_cast<std::uint8_t>(g);
+                }
+                std::uint64_t grown{((f[y] & open_east[y]) << 1) | ((f[y] >> 1) & open_east[y])};
+                if (y > 0) {
+                    grown |= f[y - 1] & open_north[y - 1];
+                }
+                if (y + 1 < height) {
+                    grown |= f[y + 1] & open_north[y];
+                }
+                n[y] = grown & ~reached[y] & row_mask;
+                reached[y] |= n[y];
+                if (n[y] != 0) {
+                    new_first = std::min(new_first, y);
+                    new_last = y;
+                }
+            }
+            // Clear the rows left behind for the next swap
+            for (std::size_t y{first[g]}; y <= last[g]; ++y) {
+                frontier[g * height + y] = 0;
+            }
+            first[g] = new_first;
+            last[g] = new_last;
+            growing = growing || new_first <= new_last;
+        }
+        frontier.swap(next);
+    }
+}
+
+std::vector<std::uint64_t> micro_mouse::center_seeds(int width, int height) {
+    std::vector<std::uint64_t> seeds(static_cast<std::size_t>(height), 0);
+    for (int y{0}; y < height; ++y) {
+        for (int x{0}; x < width; ++x) {
+            if (is_center_cell(x, y, width, height)) {
+                seeds[static_cast<std::size_t>(y)] |= std::uint64_t{1} << x;
+            }
+        }
+    }
+    return seeds;
+}
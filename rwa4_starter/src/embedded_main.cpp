@@ -0,0 +1,161 @@
+#include <unistd.h>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include "command_line.hpp"
+#include "embedded_mouse.hpp"
+#include "embedded_solvers.hpp"
+#include "serial_link.hpp"
+
+namespace {
+using micro_mouse::CommandLine;
+using micro_mouse::EmbeddedRun;
+using micro_mouse::SerialLink;
+
+// The mouse and the policy of a run live in static storage, so the link
+// map accounts for all the memory a solver needs
+template <template <int, int> class Policy, int W, int H>
+EmbeddedRun explore(SerialLink& link, int max_moves) {
+    static micro_mouse::EmbeddedMouse<W, H> mouse{link};
+    static Policy<W, H> policy;
+    return micro_mouse::explore_embedded(mouse, policy, max_moves);
+}
+
+// A solver for each maze size the embedded build supports
+struct Solver {
+    std::string_view name;
+    EmbeddedRun (*explore16)(SerialLink&, int);
+    EmbeddedRun (*explore32)(SerialLink&, int);
+    std::size_t footprint16;
+    std::size_t footprint32;
+};
+
+template <template <int, int> class Policy>
+constexpr Solver solver(std::string_view name) {
+    return {name,
+            explore<Policy, 16, 16>,
+            explore<Policy, 32, 32>,
+            micro_mouse::embedded_footprint<Policy, 16, 16>(),
+            micro_mouse::embedded_footprint<Policy, 32, 32>()};
+}
+
+constexpr std::array<Solver, 4> solvers{{
+    solver<micro_mouse::EmbeddedFloodFill>("flood-fill"),
+    solver<micro_mouse::EmbeddedWallFollower>("wall-follower"),
+    solver<micro_mouse::EmbeddedDfs>("dfs"),
+    solver<micro_mouse::EmbeddedFrontier>("frontier"),
+}};
+
+int to_int(std::string_view text) {
+    int value{0};
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+// One CSV line in a fixed buffer
+class CsvLine {
+public:
+    CsvLine& append(std::string_view field) {
+        if (size_ != 0) {
+            put(',');
+        }
+        for (const char c : field) {
+            put(c);
+        }
+        return *this;
+    }
+
+    CsvLine& append(std::size_t value) {
+        char digits[20];
+        const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        return append(std::string_view{digits, static_cast<std::size_t>(result.ptr - digits)});
+    }
+
+    // Write the line and a newline; false if stdout is closed
+    bool print() {
+        put('\n');
+        return ::write(STDOUT_FILENO, data_.data(), size_) == static_cast<ssize_t>(size_);
+    }
+
+private:
+    void put(char c) {
+        if (size_ < data_.size()) {
+            data_[size_++] = c;
+        }
+    }
+
+    std::array<char, 96> data_{};
+    std::size_t size_{0};
+};
+
+// One row per solver: static bytes of the mouse and the policy state, and
+// of the link every solver shares
+int print_footprint() {
+    if (!CsvLine{}.append("solver").append("bytes_16x16").append("bytes_32x32")
+             .append("link_bytes").print()) {
+        return 1;
+    }
+    for (const auto& entry : solvers) {
+        if (!CsvLine{}.append(entry.name).append(entry.footprint16)
+                 .append(entry.footprint32).append(sizeof(SerialLink)).print()) {
+            return 1;
+        }
+    }
+    return 0;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: rwa4_cpp [--solver <name>] [--max-moves <n>]
+    //        rwa4_cpp --footprint
+    const Solver* chosen{&solvers[0]};
+    int max_moves{1000};
+    for (int i{1}; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--footprint") {
+            return print_footprint();
+        }
+        if (arg == "--max-moves" && i + 1 < argc) {
+            max_moves = to_int(argv[++i]);
+        } else if (arg == "--solver" && i + 1 < argc) {
+            const std::string_view name{argv[++i]};
+            chosen = nullptr;
+            for (const auto& entry : solvers) {
+                if (entry.name == name) {
+                    chosen = &entry;
+                }
+            }
+            if (chosen == nullptr) {
+                SerialLink::log(CommandLine{"unknown solver"}.append(name).view());
+                return 2;
+            }
+        }
+    }
+
+    SerialLink link{STDIN_FILENO, STDOUT_FILENO};
+    const int width{link.maze_width()};
+    const int height{link.maze_height()};
+    EmbeddedRun run;
+    if (width == 16 && height == 16) {
+        run = chosen->explore16(link, max_moves);
+    } else if (width == 32 && height == 32) {
+        run = chosen->explore32(link, max_moves);
+    } else {
+        SerialLink::log(CommandLine{"unsupported maze size"}.append(width).append(height).view());
+        return 1;
+    }
+    link.flush();
+    SerialLink::log(CommandLine{chosen->name}
+                        .append(run.reached_center ? "reached the center in"
+                                                   : "gave up after")
+                        .append(run.moves)
+                        .append("moves,")
+                        .append(run.cells_explored)
+                        .append("cells explored")
+                        .view());
+    return run.reached_center ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include "flood_fill.hpp"
+
+#include <algorithm>
+
+#include "distance_kernel.hpp"
+
+namespace {
+constexpr micro_mouse::Direction all_directions[]{
+    micro_mouse::Direction::NORTH, micro_mouse::Direction::EAST,
+    micro_mouse::Direction::SOUTH, micro_mouse::Direction::WEST};
+}  // namespace
+
+micro_mouse::FloodFill::FloodFill(const WallMap& map)
+    : map_{map},
+      distances_(static_cast<std::size_t>(map.width() * map.height()), 0) {
+    recompute();
+}
+
+void micro_mouse::FloodFill::recompute() {
+    compute_distances(map_, center_seeds(map_.width(), map_.height()), true,
+                      distances_);
+}
+
+int micro_mouse::FloodFill::expected_distance(int x, int y) const {
+    if (is_center_cell(x, y, map_.width(), map_.height())) {
+        return 0;
+    }
+    int best{unreachable()};
+    for (const auto d : all_directions) {
+        if (!map_.has_wall(x, y, d)) {
+            best = std::min(best, distance(x + dx_of(d), y + dy_of(d)) + 1);
+        }
+    }
+    // Capping stops a walled-off region from counting up forever
+    return std::min(best, unreachable());
+}
+
+std::size_t micro_mouse::FloodFill::add_wall(int x, int y, Direction d) {
+    const int width{map_.width()};
+    pending_.clear();
+    pending_.push_back(y * width + x);
+    if (map_.contains(x + dx_of(d), y + dy_of(d))) {
+        pending_.push_back((y + dy_of(d)) * width + x + dx_of(d));
+    }
+    // Only cells in pending_ can be inconsistent; a cell that changes makes
+    // its open neighbours suspect in turn.
+    std::size_t touched{0};
+    while (!pending_.empty()) {
+        const int cell{pending_.back()};
+        pending_.pop_back();
+        ++touched;
+        const int cx{cell % width};
+        const int cy{cell / width};
+        const int expected{expected_distance(cx, cy)};
+        auto& distance = distances_[static_cast<std::size_t>(cell)];
+        if (distance == expected) {
+            continue;
+        }
+        distance = expected;
+        if (track_changes_) {
+            changes_.push_back(cell);
+        }
+        for (const auto n : all_directions) {
+            if (!map_.has_wall(cx, cy, n)) {
+                pending_.push_back((cy + dy_of(n)) * width + cx + dx_of(n));
+            }
+        }
+    }
+    ++stats_.walls;
+    stats_.cells_touched += touched;
+    return touched;
+}
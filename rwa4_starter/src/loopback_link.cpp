@@ -0,0 +1,82 @@
+#include "loopback_link.hpp"
+
+#include "cpu_time.hpp"
+
+micro_mouse::LoopbackLink::LoopbackLink(ProtocolServer& server)
+    : server_{server},
+      requests_{*this},
+      replies_{*this},
+      in_{&replies_},
+      out_{&requests_} {
+}
+
+micro_mouse::LoopbackLink::RequestBuffer::int_type
+micro_mouse::LoopbackLink::RequestBuffer::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        pending.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize micro_mouse::LoopbackLink::RequestBuffer::xsputn(
+    const char* s, std::streamsize n) {
+    pending.append(s, static_cast<std::size_t>(n));
+    return n;
+}
+
+int micro_mouse::LoopbackLink::RequestBuffer::sync() {
+    link_.serve();
+    return 0;
+}
+
+void micro_mouse::LoopbackLink::ReplyBuffer::append(std::string_view text) {
+    // Drop what the client already consumed before growing the buffer
+    const auto consumed = static_cast<std::size_t>(gptr() - eback());
+    data_.erase(0, consumed);
+    data_.append(text);
+    setg(data_.data(), data_.data(), data_.data() + data_.size());
+}
+
+micro_mouse::LoopbackLink::ReplyBuffer::int_type
+micro_mouse::LoopbackLink::ReplyBuffer::underflow() {
+    if (gptr() == egptr()) {
+        // The client reads without flushing first; serve what it wrote
+        link_.serve();
+    }
+    if (gptr() == egptr()) {
+        return traits_type::eof();
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+void micro_mouse::LoopbackLink::serve() {
+    const double start{thread_cpu_seconds()};
+    std::string& pending = requests_.pending;
+    std::size_t begin{0};
+    // The framing can change after any command, so look again each time
+    while (begin < pending.size()) {
+        const std::string_view rest{std::string_view{pending}.substr(begin)};
+        if (server_.is_binary()) {
+            const std::size_t used{server_.handle_frame(rest, reply_)};
+            if (used == 0) {
+                break;
+            }
+            if (!reply_.empty()) {
+                replies_.append(reply_);
+            }
+            begin += used;
+            continue;
+        }
+        const std::size_t end{rest.find('\n')};
+        if (end == std::string_view::npos) {
+            break;
+        }
+        if (server_.handle(rest.substr(0, end), reply_)) {
+            reply_.push_back('\n');
+            replies_.append(reply_);
+        }
+        begin += end + 1;
+    }
+    pending.erase(0, begin);
+    server_seconds_ += thread_cpu_seconds() - start;
+}
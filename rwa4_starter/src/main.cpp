@@ -1,34 +1,419 @@
+#include <charconv>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <utility>
 
+#include "cpu_time.hpp"
 #include "maze_api.hpp"
+#include "maze_simulator.hpp"
+#include "navigator.hpp"
+#include "replay_backend.hpp"
+#include "solver_policy.hpp"
 
 void log(const std::string& text) {
   std::cerr << text << std::endl;
 }
 
+/**
+ * @brief Format a number with a fixed number of decimals
+ * @param value Number
+ * @param decimals Digits after the point
+ * @return The number as text
+ */
+std::string fixed(double value, int decimals) {
+  std::ostringstream text;
+  text << std::fixed << std::setprecision(decimals) << value;
+  return text.str();
+}
+
+/**
+ * @brief Format a count averaged over runs
+ * @param total Count summed over the runs
+ * @param runs Number of runs
+ * @return The count itself for a single run, else the average to one
+ * decimal
+ */
+std::string per_run(double total, int runs) {
+  return fixed(total / runs, runs == 1 ? 0 : 1);
+}
+
 using MMS = micro_mouse::MazeControlAPI;
 
-int main() {
-  log("Running...");
-  MMS::set_color(0, 0, 'G');
-  MMS::set_text(0, 0, "S");
-  
-  MMS::set_text(7, 7, "(7,7)");
-  MMS::set_text(7, 8, "(7,8)");
-  MMS::set_text(8, 7, "(8,7)");
-  MMS::set_text(8, 8, "(8,8)");
-  MMS::set_color(7, 7, 'y');
-  MMS::set_color(7, 8, 'y');
-  MMS::set_color(8, 7, 'y');
-  MMS::set_color(8, 8, 'y');
-  while (true) {
-    if (!MMS::has_wall_left()) {
-      MMS::turn_left();
+/**
+ * @brief Log how many wall queries reached the simulator
+ * @param sensing Accumulated sensing counters
+ */
+void log_sensing_stats(const micro_mouse::SensingStats& sensing) {
+  log("wall queries: " + std::to_string(sensing.queries) + " sent, " +
+      std::to_string(sensing.avoided) + " answered from known walls");
+}
+
+/**
+ * @brief Log how many edges were deduced instead of sensed
+ * @param inference Accumulated deduction counters
+ * @param runs Number of runs they were accumulated over
+ */
+void log_inference_stats(const micro_mouse::InferenceStats& inference, int runs) {
+  log("edges deduced from the maze rules: " +
+      per_run(static_cast<double>(inference.total()), runs) +
+      " per run (pegs " + std::to_string(inference.pegs) + ", center " +
+      std::to_string(inference.center) + ", start " +
+      std::to_string(inference.start) + ", dead ends " +
+      std::to_string(inference.dead_ends) + ")");
+}
+
+/**
+ * @brief Log how much was explored and how short the known route is
+ * @param cells_explored Cells visited, summed over the runs
+ * @param proven Runs whose route was known to be a shortest one
+ * @param runs Number of runs
+ */
+void log_exploration(long cells_explored, int proven, int runs) {
+  log("cells explored: " + per_run(static_cast<double>(cells_explored), runs) +
+      " per run; shortest route proven in " + std::to_string(proven) + " of " +
+      std::to_string(runs) + " runs");
+}
+
+/**
+ * @brief Log how the reset button was watched
+ * @param reset Reset check counters of the session
+ */
+void log_reset_stats(const micro_mouse::ResetStats& reset) {
+  log("reset checks: " + std::to_string(reset.checks) + " (" +
+      std::to_string(reset.piggybacked) + " without a round-trip), resets: " +
+      std::to_string(reset.resets));
+}
+
+/**
+ * @brief Log the cost of a speed run against moving one cell per command
+ * @param commands Commands issued by the speed runs
+ * @param time Estimated time of the speed runs
+ * @param cell_commands Commands needed moving one cell per command
+ * @param cell_time Estimated time moving one cell per command
+ * @param runs Number of runs the arguments were summed over
+ */
+void log_speed_run(double commands, double time, double cell_commands,
+                   double cell_time, int runs) {
+  log("speed run: " + per_run(commands, runs) + " commands, " +
+      fixed(time / runs, 2) + " s estimated; one cell per move: " +
+      per_run(cell_commands, runs) + " commands, " + fixed(cell_time / runs, 2) +
+      " s");
+}
+
+/**
+ * @brief Log the average repair cost of a set of runs
+ * @param repair Accumulated repair counters
+ */
+void log_repair_stats(const micro_mouse::RepairStats& repair) {
+  const double per_wall{repair.walls == 0 ? 0.0
+                                          : static_cast<double>(repair.cells_touched) /
+                                                static_cast<double>(repair.walls)};
+  log("walls discovered: " + std::to_string(repair.walls) +
+      ", cells touched: " + std::to_string(repair.cells_touched) + " (" +
+      fixed(per_wall, 2) + " per wall)");
+}
+
+/**
+ * @brief Command-line options
+ */
+struct Options {
+  std::string maze_file;                       ///< Run headless on this maze
+  int runs{1000};                              ///< Number of headless runs
+  int max_moves{1000};                         ///< Move budget of each run
+  bool paint{false};                           ///< Paint the distances
+  std::chrono::milliseconds frame_interval{0}; ///< Minimum time between frames
+  std::string memory_file;                     ///< Learned map to reuse
+  micro_mouse::ResetPolicy reset_policy;       ///< When to check for a reset
+  std::string record_file;                     ///< Trace of the mms session
+  std::string replay_file;                     ///< Trace to replay
+  bool maze_rules{false};                      ///< Deduce edges from the rules
+  micro_mouse::Exploration exploration{micro_mouse::Exploration::TO_CENTER};
+  std::string solver{"flood-fill"};            ///< Name of the exploration
+  micro_mouse::Explorer explorer{micro_mouse::run_flood_fill};
+};
+
+/**
+ * @brief Reset policy of a run against mms
+ *
+ * The reset button must work in the simulator, so unless told otherwise
+ * the mouse checks with every motion; the checks ride along with the
+ * motions.
+ * @param options Command-line options
+ * @return The policy to use
+ */
+micro_mouse::ResetPolicy simulator_reset_policy(const Options& options) {
+  auto policy = options.reset_policy;
+  if (policy.every_motions == 0 && policy.interval.count() == 0) {
+    policy.every_motions = 1;
+  }
+  return policy;
+}
+
+/**
+ * @brief Run the mouse once, reusing the learned map if there is one
+ * @param session Session of the mouse
+ * @param paint Paint the distances in the simulator
+ * @param max_moves Move budget of the exploration, unlimited if 0
+ * @param options Command-line options
+ * @return Outcome of the run
+ */
+micro_mouse::RunResult run_once(micro_mouse::MazeSession& session, bool paint,
+                                int max_moves, const Options& options) {
+  if (options.memory_file.empty()) {
+    return micro_mouse::run_mouse(session, paint, max_moves, options.maze_rules,
+                                  options.exploration, options.explorer);
+  }
+  return micro_mouse::run_mouse_with_memory(session, paint, max_moves,
+                                            options.memory_file, options.maze_rules,
+                                            options.exploration, options.explorer);
+}
+
+/**
+ * @brief Run the mouse repeatedly against an in-process simulator
+ * @param options Maze, number of runs and move budget
+ * @return Process exit status
+ */
+int run_headless(const Options& options) {
+  micro_mouse::MazeLayout layout;
+  try {
+    layout = micro_mouse::load_maze_file(options.maze_file);
+  } catch (const std::exception& e) {
+    // Missing or malformed maze file
+    log(options.maze_file + ": " + e.what());
+    return 2;
+  }
+  micro_mouse::MazeSimulator simulator{std::move(layout)};
+  micro_mouse::MazeSession session{simulator};
+  session.set_display_interval(options.frame_interval);
+  session.set_reset_policy(options.reset_policy);
+  const int runs{options.runs};
+  int goals{0};
+  int warm_starts{0};
+  long total_moves{0};
+  long cells_explored{0};
+  int proven{0};
+  micro_mouse::RepairStats repair;
+  micro_mouse::SensingStats sensing;
+  micro_mouse::InferenceStats inference;
+  std::size_t commands{0};
+  double run_commands{0.0};
+  double cell_commands{0.0};
+  double run_time{0.0};
+  double cell_time{0.0};
+  const auto start = std::chrono::steady_clock::now();
+  for (int run{0}; run < runs; ++run) {
+    simulator.restart();
+    const auto result =
+        run_once(session, options.paint, options.max_moves, options);
+    warm_starts += result.warm_start ? 1 : 0;
+    session.flush();
+    run_commands += static_cast<double>(result.speed_run.motions.size());
+    cell_commands += result.speed_run.cells + result.speed_run.turns;
+    run_time += result.speed_run.time;
+    cell_time += result.speed_run.cell_by_cell_time;
+    commands += session.get_channel_stats().commands;
+    repair.walls += result.repair.walls;
+    repair.cells_touched += result.repair.cells_touched;
+    sensing.queries += result.sensing.queries;
+    sensing.avoided += result.sensing.avoided;
+    inference.pegs += result.inference.pegs;
+    inference.center += result.inference.center;
+    inference.start += result.inference.start;
+    inference.dead_ends += result.inference.dead_ends;
+    goals += simulator.get_run_stats().goal_reached ? 1 : 0;
+    total_moves += simulator.get_run_stats().moves;
+    cells_explored += result.cells_explored;
+    proven += result.bounds.met() ? 1 : 0;
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const auto display = session.get_display_stats();
+  log(options.solver + ": " + std::to_string(runs) + " runs in " +
+      std::to_string(elapsed.count()) + " s (" +
+      std::to_string(runs / elapsed.count()) + " runs/s), " +
+      std::to_string(total_moves) + " moves, goal reached in " +
+      std::to_string(goals) + " runs");
+  if (!options.memory_file.empty()) {
+    log("warm starts from " + options.memory_file + ": " +
+        std::to_string(warm_starts));
+  }
+  log("commands: " + std::to_string(commands) + ", display updates: " +
+      std::to_string(display.requested) + " requested, " +
+      std::to_string(display.sent) + " sent");
+  log_exploration(cells_explored, proven, runs);
+  log_repair_stats(repair);
+  log_sensing_stats(sensing);
+  if (options.maze_rules) {
+    log_inference_stats(inference, runs);
+  }
+  log_reset_stats(session.get_reset_stats());
+  log_speed_run(run_commands, run_time, cell_commands, cell_time, runs);
+  return 0;
+}
+
+/**
+ * @brief Replay a recorded mms session repeatedly, without the simulator
+ *
+ * The mouse runs as under mms (painting, same reset policy), so the same
+ * options as for the recording must be given.
+ * @param options Trace file and number of replays
+ * @return Process exit status
+ */
+int run_replay(const Options& options) {
+  micro_mouse::ReplayBackend replay{options.replay_file};
+  double cpu_seconds{0.0};
+  for (int run{0}; run < options.runs; ++run) {
+    replay.rewind();
+    micro_mouse::MazeSession session{replay};
+    session.set_reset_policy(simulator_reset_policy(options));
+    const double start{micro_mouse::thread_cpu_seconds()};
+    run_once(session, true, 0, options);
+    session.flush();
+    cpu_seconds += micro_mouse::thread_cpu_seconds() - start;
+    if (!replay.finished()) {
+      log("the solver stopped before the end of the trace");
+      return 1;
     }
-    while (MMS::has_wall_front()) {
-      MMS::turn_right();
+  }
+  log(std::to_string(options.runs) + " replays, " +
+      std::to_string(cpu_seconds / options.runs * 1e6) +
+      " us of solver CPU per replay");
+  log("recorded session: " + std::to_string(replay.get_recorded_seconds()) +
+      " s, " + std::to_string(replay.get_recorded_wait_seconds()) +
+      " s of it waiting on the simulator");
+  return 0;
+}
+
+/**
+ * @brief Parse the number given to an option
+ * @param option Name of the option
+ * @param text Its argument
+ * @return The number
+ * @throw std::invalid_argument if @p text is not a whole number that fits
+ * in an int
+ */
+int parse_number(const std::string& option, const std::string& text) {
+  int value{0};
+  const char* end{text.data() + text.size()};
+  const auto [last, error] = std::from_chars(text.data(), end, value);
+  if (text.empty() || error != std::errc{} || last != end) {
+    throw std::invalid_argument{option + " expects a number, got '" + text + "'"};
+  }
+  return value;
+}
+
+/**
+ * @brief Read the command-line options
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return The options, with the explorer of the solver picked
+ * @throw std::invalid_argument on a malformed number or an unknown solver
+ */
+Options parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i{1}; i < argc; ++i) {
+    const std::string option{argv[i]};
+    if (option == "--paint") {
+      options.paint = true;
+    } else if (option == "--maze-rules") {
+      options.maze_rules = true;
+    } else if (option == "--prove-shortest") {
+      options.exploration = micro_mouse::Exploration::PROVE_SHORTEST;
+    } else if (i + 1 == argc) {
+      break;
+    } else if (option == "--maze") {
+      options.maze_file = argv[++i];
+    } else if (option == "--runs") {
+      options.runs = parse_number(option, argv[++i]);
+    } else if (option == "--max-moves") {
+      options.max_moves = parse_number(option, argv[++i]);
+    } else if (option == "--frame-ms") {
+      options.frame_interval =
+          std::chrono::milliseconds{parse_number(option, argv[++i])};
+    } else if (option == "--memory") {
+      options.memory_file = argv[++i];
+    } else if (option == "--reset-every") {
+      options.reset_policy.every_motions = parse_number(option, argv[++i]);
+    } else if (option == "--reset-ms") {
+      options.reset_policy.interval =
+          std::chrono::milliseconds{parse_number(option, argv[++i])};
+    } else if (option == "--record") {
+      options.record_file = argv[++i];
+    } else if (option == "--replay") {
+      options.replay_file = argv[++i];
+    } else if (option == "--solver") {
+      options.solver = argv[++i];
     }
-    MMS::move_forward();
   }
-}
\ No newline at end of file
+  options.explorer = micro_mouse::find_solver(options.solver);
+  return options;
+}
+
+int main(int argc, char* argv[]) {
+  Options options;
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::invalid_argument& e) {
+    // Malformed number or unknown solver
+    log(e.what());
+    log("usage: rwa4_cpp [--frame-ms <n>] [--memory <file>] [--maze-rules]\n"
+        "                [--prove-shortest] [--solver <name>]\n"
+        "                [--reset-every <motions>] [--reset-ms <n>]\n"
+        "                [--record <trace> | --replay <trace> [--runs <n>]]\n"
+        "                [--maze <file> [--runs <n>] [--max-moves <n>] [--paint]]");
+    return 2;
+  }
+  if (!options.maze_file.empty()) {
+    return run_headless(options);
+  }
+  if (!options.replay_file.empty()) {
+    return run_replay(options);
+  }
+  if (!options.record_file.empty()) {
+    MMS::record_to(options.record_file);
+  }
+  MMS::set_display_interval(options.frame_interval);
+  MMS::get_session().set_reset_policy(simulator_reset_policy(options));
+
+  log("Running...");
+  // Painted again after a reset wipes the display
+  auto& session = MMS::get_session();
+  session.set_marker(0, 0, 'G', "S");
+  session.set_marker(7, 7, 'y', "(7,7)");
+  session.set_marker(7, 8, 'y', "(7,8)");
+  session.set_marker(8, 7, 'y', "(8,7)");
+  session.set_marker(8, 8, 'y', "(8,8)");
+  const auto result = run_once(session, true, 0, options);
+  MMS::flush();
+  const auto stats = MMS::get_channel_stats();
+  const auto display = MMS::get_display_stats();
+  log(std::string{result.reached_center ? "Reached" : "Did not reach"} +
+      " the center; commands: " + std::to_string(stats.commands) +
+      ", flushes: " + std::to_string(stats.flushes) +
+      ", round-trips: " + std::to_string(stats.round_trips) +
+      ", display updates sent: " + std::to_string(display.sent) + "/" +
+      std::to_string(display.requested));
+  log_exploration(result.cells_explored, result.bounds.met() ? 1 : 0, 1);
+  if (result.bounds.goal_x >= 0) {
+    log("known route from the start ends in (" +
+        std::to_string(result.bounds.goal_x) + "," +
+        std::to_string(result.bounds.goal_y) + ")");
+    MMS::set_color(result.bounds.goal_x, result.bounds.goal_y, 'G');
+    MMS::flush();
+  }
+  log_repair_stats(result.repair);
+  log_sensing_stats(result.sensing);
+  if (options.maze_rules) {
+    log_inference_stats(result.inference, 1);
+  }
+  log_reset_stats(MMS::get_session().get_reset_stats());
+  log_speed_run(static_cast<double>(result.speed_run.motions.size()),
+                result.speed_run.time,
+                result.speed_run.cells + result.speed_run.turns,
+                result.speed_run.cell_by_cell_time, 1);
+}
@@ -1,112 +1,140 @@
 #include "maze_api.hpp"
 
-#include <cstdlib>
 #include <iostream>
+#include <memory>
+
+#include "recording_backend.hpp"
+#include "stream_backend.hpp"
+
+namespace {
+micro_mouse::MazeBackend& standard_io() {
+    static micro_mouse::StreamBackend backend{std::cin, std::cout};
+    return backend;
+}
+
+// Backend installed with set_backend(), not counting the recorder
+micro_mouse::MazeBackend*& installed_backend() {
+    static micro_mouse::MazeBackend* backend{&standard_io()};
+    return backend;
+}
+
+std::unique_ptr<micro_mouse::RecordingBackend>& recorder() {
+    static std::unique_ptr<micro_mouse::RecordingBackend> instance;
+    return instance;
+}
+
+micro_mouse::MazeSession& session() {
+    static micro_mouse::MazeSession instance{standard_io()};
+    return instance;
+}
+}  // namespace
 
 int micro_mouse::MazeControlAPI::get_maze_width() {
-    std::cout << "mazeWidth" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return atoi(response.c_str());
+    return session().get_maze_width();
 }
 
 int micro_mouse::MazeControlAPI::get_maze_height() {
-    std::cout << "mazeHeight" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return atoi(response.c_str());
+    return session().get_maze_height();
 }
 
 bool micro_mouse::MazeControlAPI::has_wall_front() {
-    std::cout << "wallFront" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return response == "true";
+    return session().has_wall_front();
 }
 
 bool micro_mouse::MazeControlAPI::has_wall_right() {
-    std::cout << "wallRight" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return response == "true";
+    return session().has_wall_right();
 }
 
 bool micro_mouse::MazeControlAPI::has_wall_left() {
-    std::cout << "wallLeft" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return response == "true";
+    return session().has_wall_left();
 }
 
 void micro_mouse::MazeControlAPI::move_forward(int distance) {
-    std::cout << "moveForward ";
-    // Don't print distance argument unless explicitly specified, for
-    // backwards compatibility with older versions of the simulator
-    if (distance != 1) {
-        std::cout << distance;
-    }
-    std::cout << std::endl;
-    std::string response;
-    std::cin >> response;
-    if (response != "ack") {
-        std::cerr << response << std::endl;
-        throw;
-    }
+    session().move_forward(distance);
 }
 
 void micro_mouse::MazeControlAPI::turn_right() {
-    std::cout << "turnRight" << std::endl;
-    std::string ack;
-    std::cin >> ack;
+    session().turn_right();
 }
 
 void micro_mouse::MazeControlAPI::turn_left() {
-    std::cout << "turnLeft" << std::endl;
-    std::string ack;
-    std::cin >> ack;
+    session().turn_left();
 }
 
 void micro_mouse::MazeControlAPI::set_wall(int x, int y, char direction) {
-    std::cout << "setWall " << x << " " << y << " " << direction << std::endl;
+    session().set_wall(x, y, direction);
 }
 
 void micro_mouse::MazeControlAPI::clear_wall(int x, int y, char direction) {
-    std::cout << "clearWall " << x << " " << y << " " << direction << std::endl;
+    session().clear_wall(x, y, direction);
 }
 
 void micro_mouse::MazeControlAPI::set_color(int x, int y, char color) {
-    std::cout << "setColor " << x << " " << y << " " << color << std::endl;
+    session().set_color(x, y, color);
 }
 
 void micro_mouse::MazeControlAPI::clear_color(int x, int y) {
-    std::cout << "clearColor " << x << " " << y << std::endl;
+    session().clear_color(x, y);
 }
 
 void micro_mouse::MazeControlAPI::clear_all_color() {
-    std::cout << "clearAllColor" << std::endl;
+    session().clear_all_color();
 }
 
 void micro_mouse::MazeControlAPI::set_text(int x, int y, const std::string& text) {
-    std::cout << "setText " << x << " " << y << " " << text << std::endl;
+    session().set_text(x, y, text);
 }
 
 void micro_mouse::MazeControlAPI::clear_text(int x, int y) {
-    std::cout << "clearText " << x << " " << y << std::endl;
+    session().clear_text(x, y);
 }
 
 void micro_mouse::MazeControlAPI::clear_all_text() {
-    std::cout << "clearAllText" << std::endl;
+    session().clear_all_text();
 }
 
 bool micro_mouse::MazeControlAPI::was_reset() {
-    std::cout << "wasReset" << std::endl;
-    std::string response;
-    std::cin >> response;
-    return response == "true";
+    return session().was_reset();
 }
 
 void micro_mouse::MazeControlAPI::ack_reset() {
-    std::cout << "ackReset" << std::endl;
-    std::string ack;
-    std::cin >> ack;
-}
\ No newline at end of file
+    session().ack_reset();
+}
+
+void micro_mouse::MazeControlAPI::flush() {
+    session().flush();
+}
+
+void micro_mouse::MazeControlAPI::set_display_interval(
+    std::chrono::milliseconds interval) {
+    session().set_display_interval(interval);
+}
+
+micro_mouse::DisplayStats micro_mouse::MazeControlAPI::get_display_stats() {
+    return session().get_display_stats();
+}
+
+micro_mouse::ChannelStats micro_mouse::MazeControlAPI::get_channel_stats() {
+    return session().get_channel_stats();
+}
+
+void micro_mouse::MazeControlAPI::reset_channel_stats() {
+    session().reset_channel_stats();
+}
+
+void micro_mouse::MazeControlAPI::set_backend(MazeBackend* backend) {
+    // The new backend has its own maze and display
+    installed_backend() = backend ? backend : &standard_io();
+    session() = MazeSession{*installed_backend()};
+    recorder().reset();
+}
+
+void micro_mouse::MazeControlAPI::record_to(const std::string& path) {
+    auto next = std::make_unique<RecordingBackend>(*installed_backend(), path);
+    session() = MazeSession{*next};
+    recorder() = std::move(next);
+}
+
+micro_mouse::MazeSession& micro_mouse::MazeControlAPI::get_session() {
+    return session();
+}
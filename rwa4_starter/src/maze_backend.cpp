@@ -0,0 +1,20 @@
+#include "maze_backend.hpp"
+
+micro_mouse::StepReply micro_mouse::MazeBackend::finish_step() {
+    StepReply reply;
+    reply.sent = std::chrono::steady_clock::now();
+    for (int turn{0}; turn < pending_step_.turns; ++turn) {
+        turn_right();
+    }
+    for (int turn{0}; turn > pending_step_.turns; --turn) {
+        turn_left();
+    }
+    reply.moved = move_forward(pending_step_.distance);
+    if (reply.moved) {
+        reply.wall_left = pending_step_.sense_left && wall_left();
+        reply.wall_front = pending_step_.sense_front && wall_front();
+        reply.wall_right = pending_step_.sense_right && wall_right();
+    }
+    reply.arrived = std::chrono::steady_clock::now();
+    return reply;
+}
@@ -0,0 +1,392 @@
+#include "maze_file.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+#include "mapped_file.hpp"
+
+namespace {
+// Largest width and height of a .num maze; coordinates past it are
+// rejected before any row is allocated for them
+constexpr long max_num_side{64};
+
+// Character at (row, column) of the map, blank past the end of a line
+char map_char(const std::vector<std::string>& lines, std::size_t row,
+              std::size_t column) {
+    const std::string& line = lines[row];
+    return column < line.size() ? line[column] : ' ';
+}
+
+bool is_post(char c) {
+    return c != '-' && c != '|' && c != ' ';
+}
+
+// Record a wall on both cells sharing the edge
+void add_wall(micro_mouse::MazeLayout& maze, int x, int y,
+              micro_mouse::Direction d) {
+    maze.walls[static_cast<std::size_t>(y * maze.width + x)] |=
+        micro_mouse::wall_bit(d);
+    const int nx = x + micro_mouse::dx_of(d);
+    const int ny = y + micro_mouse::dy_of(d);
+    if (nx >= 0 && ny >= 0 && nx < maze.width && ny < maze.height) {
+        maze.walls[static_cast<std::size_t>(ny * maze.width + nx)] |=
+            micro_mouse::wall_bit(micro_mouse::opposite_of(d));
+    }
+}
+}  // namespace
+
+micro_mouse::MazeLayout micro_mouse::parse_map_maze(std::istream& in) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    while (!lines.empty() &&
+           lines.back().find_first_not_of(' ') == std::string::npos) {
+        lines.pop_back();
+    }
+    if (lines.size() < 3 || lines.size() % 2 == 0 || lines[0].empty()) {
+        throw std::invalid_argument{"maze map must have 2 * height + 1 lines"};
+    }
+    std::size_t pitch{1};
+    while (pitch < lines[0].size() && !is_post(lines[0][pitch])) {
+        ++pitch;
+    }
+    if (pitch < 2 || pitch >= lines[0].size()) {
+        throw std::invalid_argument{"cannot locate the posts of the maze map"};
+    }
+
+    MazeLayout maze;
+    maze.width = static_cast<int>((lines[0].size() - 1) / pitch);
+    maze.height = static_cast<int>(lines.size() / 2);
+    maze.walls.assign(static_cast<std::size_t>(maze.width * maze.height), 0);
+    for (int row{0}; row < maze.height; ++row) {
+        // The map lists the north row first
+        const int y = maze.height - 1 - row;
+        const auto wall_row = static_cast<std::size_t>(2 * row);
+        for (int x{0}; x < maze.width; ++x) {
+            const auto column = static_cast<std::size_t>(x) * pitch;
+            if (map_char(lines, wall_row, column + 1) != ' ') {
+                add_wall(maze, x, y, Direction::NORTH);
+            }
+            if (map_char(lines, wall_row + 2, column + 1) != ' ') {
+                add_wall(maze, x, y, Direction::SOUTH);
+            }
+            if (map_char(lines, wall_row + 1, column) != ' ') {
+                add_wall(maze, x, y, Direction::WEST);
+            }
+            if (map_char(lines, wall_row + 1, column + pitch) != ' ') {
+                add_wall(maze, x, y, Direction::EAST);
+            }
+        }
+    }
+    return maze;
+}
+
+micro_mouse::MazeLayout micro_mouse::parse_num_maze(std::istream& in) {
+    struct Entry {
+        int x, y;
+        int sides[4];
+    };
+    std::vector<Entry> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields{line};
+        Entry e{};
+        if (!(fields >> e.x >> e.y >> e.sides[0] >> e.sides[1] >> e.sides[2] >>
+              e.sides[3]) ||
+            e.x < 0 || e.y < 0) {
+            throw std::invalid_argument{"malformed maze num line: " + line};
+        }
+        if (e.x >= max_num_side || e.y >= max_num_side) {
+            throw std::invalid_argument{"maze must be 1 to 64 cells wide and high"};
+        }
+        entries.push_back(e);
+    }
+    if (entries.empty()) {
+        throw std::invalid_argument{"maze num file is empty"};
+    }
+
+    MazeLayout maze;
+    for (const auto& e : entries) {
+        maze.width = std::max(maze.width, e.x + 1);
+        maze.height = std::max(maze.height, e.y + 1);
+    }
+    maze.walls.assign(static_cast<std::size_t>(maze.width * maze.height), 0);
+    for (const auto& e : entries) {
+        for (int side{0}; side < 4; ++side) {
+            if (e.sides[side] != 0) {
+                add_wall(maze, e.x, e.y, static_cast<Direction>(side));
+            }
+        }
+    }
+    return maze;
+}
+
+namespace {
+// Walls found by a scan, one mask per grid line, bit x for column x:
+// horizontal[y] holds the south sides of row y (the north sides of the top
+// row at index height), west[y] the west sides of row y, and bit 0 of
+// last_east[y] the east side of its last cell
+struct WallRows {
+    std::vector<std::uint64_t> horizontal;
+    std::vector<std::uint64_t> west;
+    std::vector<std::uint64_t> last_east;
+};
+
+// Write the rows into a map, every edge known and every cell visited
+micro_mouse::WallMap pack(int width, int height, const WallRows& rows) {
+    using micro_mouse::BitArray;
+    micro_mouse::WallMap map{width, height};
+    const auto w = static_cast<std::size_t>(width);
+    const auto h = static_cast<std::size_t>(height);
+    const std::size_t vertical_base{w * (h + 1)};
+    const std::size_t edges{vertical_base + (w + 1) * h};
+    BitArray walls{edges};
+    BitArray known{edges};
+    BitArray visited{w * h};
+    const std::uint64_t row{BitArray::low_mask(w)};
+    for (std::size_t line{0}; line <= h; ++line) {
+        walls.deposit(line * w, w, rows.horizontal[line]);
+        known.deposit(line * w, w, row);
+    }
+    for (std::size_t y{0}; y < h; ++y) {
+        const std::size_t first{vertical_base + y * (w + 1)};
+        walls.deposit(first, w, rows.west[y]);
+        walls.deposit(first + w, 1, rows.last_east[y]);
+        known.deposit(first, w, row);
+        known.deposit(first + w, 1, 1);
+        visited.deposit(y * w, w, row);
+    }
+    map.restore(walls.words().data(), known.words().data(), visited.words().data());
+    return map;
+}
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parse an optionally signed integer at p, after blanks; false if there is
+// none before the end of the line
+bool parse_int(const char*& p, const char* end, long& value) {
+    while (p != end && is_blank(*p)) {
+        ++p;
+    }
+    const bool negative{p != end && *p == '-'};
+    if (negative) {
+        ++p;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+    value = 0;
+    while (p != end && *p >= '0' && *p <= '9' && value < (1L << 40)) {
+        value = value * 10 + (*p++ - '0');
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+micro_mouse::WallMap parse_num_text(std::string_view text) {
+    // Sides of each cell, by row; the map is sized once the largest
+    // coordinates are known
+    std::vector<std::uint64_t> north;
+    std::vector<std::uint64_t> east;
+    std::vector<std::uint64_t> south;
+    std::vector<std::uint64_t> west;
+    int width{0};
+    int height{0};
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    while (p != end) {
+        const char* eol = p;
+        while (eol != end && *eol != '\n') {
+            ++eol;
+        }
+        const char* const line = p;
+        long fields[6]{};
+        bool complete{true};
+        bool empty{true};
+        for (const char* q = p; q != eol; ++q) {
+            empty = empty && is_blank(*q);
+        }
+        for (auto& field : fields) {
+            complete = complete && parse_int(p, eol, field);
+        }
+        if (!empty) {
+            if (!complete || fields[0] < 0 || fields[1] < 0) {
+                throw std::invalid_argument{"malformed maze num line: " +
+                                            std::string{line, eol}};
+            }
+            if (fields[0] >= max_num_side || fields[1] >= max_num_side) {
+                throw std::invalid_argument{"maze must be 1 to 64 cells wide and high"};
+            }
+            const auto x = static_cast<int>(fields[0]);
+            const auto y = static_cast<std::size_t>(fields[1]);
+            if (y >= north.size()) {
+                north.resize(y + 1, 0);
+                east.resize(y + 1, 0);
+                south.resize(y + 1, 0);
+                west.resize(y + 1, 0);
+            }
+            const std::uint64_t bit{std::uint64_t{1} << x};
+            north[y] |= fields[2] != 0 ? bit : 0;
+            east[y] |= fields[3] != 0 ? bit : 0;
+            south[y] |= fields[4] != 0 ? bit : 0;
+            west[y] |= fields[5] != 0 ? bit : 0;
+            width = std::max(width, x + 1);
+            height = std::max(height, static_cast<int>(y) + 1);
+        }
+        p = eol == end ? end : eol + 1;
+    }
+    if (height == 0) {
+        throw std::invalid_argument{"maze num file is empty"};
+    }
+    // A wall seen from either side is a wall
+    const auto h = static_cast<std::size_t>(height);
+    WallRows rows{std::vector<std::uint64_t>(h + 1, 0), std::vector<std::uint64_t>(h, 0),
+                  std::vector<std::uint64_t>(h, 0)};
+    for (std::size_t y{0}; y < h; ++y) {
+        rows.horizontal[y] |= south[y];
+        rows.horizontal[y + 1] |= north[y];
+        rows.west[y] = west[y] | (east[y] << 1);
+        rows.last_east[y] = (east[y] >> (width - 1)) & 1U;
+    }
+    return pack(width, height, rows);
+}
+
+micro_mouse::WallMap parse_map_text(std::string_view text) {
+    // Masks of the text lines, north line first, and whether the post
+    // closing each line holds a wall
+    std::vector<std::uint64_t> lines;
+    std::vector<std::uint64_t> last_posts;
+    std::size_t pitch{0};
+    int width{0};
+    std::size_t content_lines{0};
+    std::size_t begin{0};
+    while (begin < text.size()) {
+        std::size_t end{text.find('\n', begin)};
+        const std::size_t next{end == std::string_view::npos ? text.size() : end + 1};
+        end = end == std::string_view::npos ? text.size() : end;
+        std::string_view line{text.substr(begin, end - begin)};
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const auto at = [&line](std::size_t column) {
+            return column < line.size() ? line[column] : ' ';
+        };
+        if (lines.empty()) {
+            if (line.empty()) {
+                break;
+            }
+            pitch = 1;
+            while (pitch < line.size() && !is_post(line[pitch])) {
+                ++pitch;
+            }
+            if (pitch < 2 || pitch >= line.size()) {
+                throw std::invalid_argument{"cannot locate the posts of the maze map"};
+            }
+            width = static_cast<int>((line.size() - 1) / pitch);
+            if (width > 64) {
+                throw std::invalid_argument{
+                    "maze must be 1 to 64 cells wide and at least 1 cell high"};
+            }
+        }
+        // Horizontal walls lie between the posts, vertical walls on them
+        const std::size_t offset{lines.size() % 2 == 0 ? 1U : 0U};
+        std::uint64_t mask{0};
+        for (int x{0}; x < width; ++x) {
+            if (at(static_cast<std::size_t>(x) * pitch + offset) != ' ') {
+                mask |= std::uint64_t{1} << x;
+            }
+        }
+        lines.push_back(mask);
+        last_posts.push_back(at(static_cast<std::size_t>(width) * pitch) != ' ' ? 1U : 0U);
+        if (line.find_first_not_of(' ') != std::string_view::npos) {
+            content_lines = lines.size();
+        }
+        begin = next;
+    }
+    if (content_lines < 3 || content_lines % 2 == 0) {
+        throw std::invalid_argument{"maze map must have 2 * height + 1 lines"};
+    }
+    const int height{static_cast<int>(content_lines / 2)};
+    const auto h = static_cast<std::size_t>(height);
+    WallRows rows{std::vector<std::uint64_t>(h + 1, 0), std::vector<std::uint64_t>(h, 0),
+                  std::vector<std::uint64_t>(h, 0)};
+    for (std::size_t y{0}; y <= h; ++y) {
+        rows.horizontal[y] = lines[2 * (h - y)];
+    }
+    for (std::size_t y{0}; y < h; ++y) {
+        rows.west[y] = lines[2 * (h - 1 - y) + 1];
+        rows.last_east[y] = last_posts[2 * (h - 1 - y) + 1];
+    }
+    return pack(width, height, rows);
+}
+}  // namespace
+
+micro_mouse::WallMap micro_mouse::parse_wall_map(std::string_view text) {
+    // Num files start with a coordinate, map files with a post
+    const auto first = std::find_if(text.begin(), text.end(), [](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) == 0;
+    });
+    if (first != text.end() && std::isdigit(static_cast<unsigned char>(*first))) {
+        return parse_num_text(text);
+    }
+    return parse_map_text(text);
+}
+
+micro_mouse::WallMap micro_mouse::load_wall_map(const std::string& path) {
+    const MappedFile file{path};
+    return parse_wall_map(file.text());
+}
+
+micro_mouse::MazeLayout micro_mouse::load_maze_file(const std::string& path) {
+    return make_layout(load_wall_map(path));
+}
+
+micro_mouse::WallMap micro_mouse::make_wall_map(const MazeLayout& layout) {
+    WallMap map{layout.width, layout.height};
+    for (int y{0}; y < layout.height; ++y) {
+        for (int x{0}; x < layout.width; ++x) {
+            for (const auto d : {Direction::NORTH, Direction::EAST}) {
+                map.set_wall(x, y, d, layout.has_wall(x, y, d));
+            }
+            map.mark_visited(x, y);
+        }
+    }
+    for (int x{0}; x < layout.width; ++x) {
+        map.set_wall(x, 0, Direction::SOUTH, layout.has_wall(x, 0, Direction::SOUTH));
+    }
+    for (int y{0}; y < layout.height; ++y) {
+        map.set_wall(0, y, Direction::WEST, layout.has_wall(0, y, Direction::WEST));
+    }
+    return map;
+}
+
+micro_mouse::MazeLayout micro_mouse::make_layout(const WallMap& map) {
+    MazeLayout layout;
+    layout.width = map.width();
+    layout.height = map.height();
+    layout.walls.assign(static_cast<std::size_t>(layout.width * layout.height), 0);
+    for (int y{0}; y < layout.height; ++y) {
+        for (int x{0}; x < layout.width; ++x) {
+            auto& walls = layout.walls[static_cast<std::size_t>(y * layout.width + x)];
+            for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                                 Direction::WEST}) {
+                walls = static_cast<std::uint8_t>(walls | (map.has_wall(x, y, d) ? wall_bit(d) : 0));
+            }
+        }
+    }
+    return layout;
+}
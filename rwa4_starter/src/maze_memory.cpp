@@ -0,0 +1,94 @@
+#include "maze_memory.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+#include "mapped_file.hpp"
+
+namespace {
+constexpr char magic[8]{'R', 'W', 'A', '4', 'M', 'A', 'Z', 'E'};
+constexpr std::uint32_t version{1};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint64_t key;
+    std::uint32_t edge_words;
+    std::uint32_t visited_words;
+};
+static_assert(sizeof(FileHeader) == 32, "the header layout is part of the file format");
+
+void write_words(std::ofstream& out, const micro_mouse::BitArray& bits) {
+    out.write(reinterpret_cast<const char*>(bits.words().data()),
+              static_cast<std::streamsize>(bits.words().size() * sizeof(std::uint64_t)));
+}
+}  // namespace
+
+void micro_mouse::save_learned_maze(const std::string& path, std::uint64_t key,
+                                    const WallMap& map) {
+    FileHeader header{};
+    std::memcpy(header.magic, magic, sizeof magic);
+    header.version = version;
+    header.width = static_cast<std::uint16_t>(map.width());
+    header.height = static_cast<std::uint16_t>(map.height());
+    header.key = key;
+    header.edge_words = static_cast<std::uint32_t>(map.get_walls().words().size());
+    header.visited_words = static_cast<std::uint32_t>(map.get_visited().words().size());
+
+    const std::string partial{path + ".tmp"};
+    {
+        std::ofstream out{partial, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(&header), sizeof header);
+        write_words(out, map.get_walls());
+        write_words(out, map.get_known());
+        write_words(out, map.get_visited());
+        if (!out) {
+            throw std::runtime_error{"cannot write learned maze " + partial};
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(partial, path, error);
+    if (error) {
+        throw std::runtime_error{"cannot replace learned maze " + path + ": " +
+                                 error.message()};
+    }
+}
+
+std::optional<micro_mouse::LearnedMaze> micro_mouse::load_learned_maze(
+    const std::string& path, int width, int height) {
+    std::optional<MappedFile> mapped;
+    try {
+        mapped.emplace(path);
+    } catch (const std::runtime_error&) {
+        // No maze learned yet, or a file that cannot be read: start afresh
+        return std::nullopt;
+    }
+    const std::string_view file{mapped->text()};
+    if (file.size() < sizeof(FileHeader)) {
+        return std::nullopt;
+    }
+    FileHeader header{};
+    std::memcpy(&header, file.data(), sizeof header);
+    if (std::memcmp(header.magic, magic, sizeof magic) != 0 ||
+        header.version != version || header.width != width ||
+        header.height != height) {
+        return std::nullopt;
+    }
+    LearnedMaze learned{header.key, WallMap{width, height}};
+    const std::size_t edge_words{learned.map.get_walls().words().size()};
+    const std::size_t visited_words{learned.map.get_visited().words().size()};
+    if (header.edge_words != edge_words || header.visited_words != visited_words ||
+        file.size() != sizeof header + (2 * edge_words + visited_words) * sizeof(std::uint64_t)) {
+        return std::nullopt;
+    }
+    // mmap returns page-aligned memory and the header is 32 bytes, so the
+    // words are suitably aligned
+    const auto* words = reinterpret_cast<const std::uint64_t*>(file.data() + sizeof header);
+    learned.map.restore(words, words + edge_words, words + 2 * edge_words);
+    return learned;
+}
@@ -0,0 +1,159 @@
+#include "maze_rules.hpp"
+
+#include <array>
+
+micro_mouse::MazeRules::MazeRules(int width, int height)
+    : width_{width}, height_{height} {
+    for (int y{0}; y < height_; ++y) {
+        for (int x{0}; x < width_; ++x) {
+            if (!in_center(x, y)) {
+                continue;
+            }
+            for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                                 Direction::WEST}) {
+                const int nx{x + dx_of(d)};
+                const int ny{y + dy_of(d)};
+                if (nx >= 0 && ny >= 0 && nx < width_ && ny < height_ &&
+                    !in_center(nx, ny)) {
+                    entrances_.push_back(Edge{x, y, d});
+                }
+            }
+        }
+    }
+}
+
+void micro_mouse::MazeRules::seed(WallMap& map) {
+    // The center is one open room
+    for (int y{0}; y < height_; ++y) {
+        for (int x{0}; x < width_; ++x) {
+            if (in_center(x, y) && in_center(x + 1, y) && x + 1 < width_) {
+                infer(map, Edge{x, y, Direction::EAST}, false, stats_.center);
+            }
+            if (in_center(x, y) && in_center(x, y + 1) && y + 1 < height_) {
+                infer(map, Edge{x, y, Direction::NORTH}, false, stats_.center);
+            }
+        }
+    }
+    // The start cell opens to the north only
+    if (width_ > 1 && height_ > 1) {
+        infer(map, Edge{0, 0, Direction::NORTH}, false, stats_.start);
+        infer(map, Edge{0, 0, Direction::EAST}, true, stats_.start);
+    }
+    while (!work_.empty()) {
+        const Edge edge{work_.back()};
+        work_.pop_back();
+        propagate(map, edge);
+    }
+}
+
+void micro_mouse::MazeRules::propagate(WallMap& map, const Edge& edge) {
+    work_.push_back(edge);
+    while (!work_.empty()) {
+        Edge e{work_.back()};
+        work_.pop_back();
+        // Name the edge by its north or east side
+        if (e.d == Direction::SOUTH || e.d == Direction::WEST) {
+            e = Edge{e.x + dx_of(e.d), e.y + dy_of(e.d), opposite_of(e.d)};
+        }
+        const bool north{e.d == Direction::NORTH};
+        const int ox{north ? e.x : e.x + 1};
+        const int oy{north ? e.y + 1 : e.y};
+        if (north) {
+            check_peg(map, e.x, e.y + 1);
+            check_peg(map, e.x + 1, e.y + 1);
+        } else {
+            check_peg(map, e.x + 1, e.y);
+            check_peg(map, e.x + 1, e.y + 1);
+        }
+        check_cell(map, e.x, e.y);
+        check_cell(map, ox, oy);
+        if (map.contains(e.x, e.y) && map.contains(ox, oy) &&
+            in_center(e.x, e.y) != in_center(ox, oy)) {
+            check_center(map);
+        }
+    }
+}
+
+void micro_mouse::MazeRules::infer(WallMap& map, const Edge& edge, bool wall,
+                                   std::size_t& counter) {
+    if (!map.contains(edge.x, edge.y) || map.is_known(edge.x, edge.y, edge.d)) {
+        return;
+    }
+    map.set_wall(edge.x, edge.y, edge.d, wall);
+    ++counter;
+    inferred_.push_back(InferredEdge{edge, wall});
+    work_.push_back(edge);
+}
+
+void micro_mouse::MazeRules::check_peg(WallMap& map, int px, int py) {
+    // Pegs on the boundary always hold a boundary wall
+    if (px <= 0 || py <= 0 || px >= width_ || py >= height_) {
+        return;
+    }
+    // The center peg stands free
+    if (in_center(px - 1, py - 1) && in_center(px, py - 1) && in_center(px - 1, py) &&
+        in_center(px, py)) {
+        return;
+    }
+    const std::array<Edge, 4> edges{Edge{px - 1, py - 1, Direction::NORTH},
+                                    Edge{px, py - 1, Direction::NORTH},
+                                    Edge{px - 1, py - 1, Direction::EAST},
+                                    Edge{px - 1, py, Direction::EAST}};
+    const Edge* unknown{nullptr};
+    int unknowns{0};
+    for (const auto& e : edges) {
+        if (map.has_wall(e.x, e.y, e.d)) {
+            return;
+        }
+        if (!map.is_known(e.x, e.y, e.d)) {
+            unknown = &e;
+            ++unknowns;
+        }
+    }
+    if (unknowns == 1) {
+        infer(map, *unknown, true, stats_.pegs);
+    }
+}
+
+void micro_mouse::MazeRules::check_cell(WallMap& map, int x, int y) {
+    if (!map.contains(x, y)) {
+        return;
+    }
+    int walls{0};
+    int unknowns{0};
+    Direction unknown{Direction::NORTH};
+    for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                         Direction::WEST}) {
+        if (!map.is_known(x, y, d)) {
+            unknown = d;
+            ++unknowns;
+        } else if (map.has_wall(x, y, d)) {
+            ++walls;
+        }
+    }
+    // Every cell can be reached, so a dead end is open on its last side
+    if (walls == 3 && unknowns == 1) {
+        infer(map, Edge{x, y, unknown}, false, stats_.dead_ends);
+    }
+}
+
+void micro_mouse::MazeRules::check_center(WallMap& map) {
+    int open{0};
+    int unknowns{0};
+    const Edge* unknown{nullptr};
+    for (const auto& e : entrances_) {
+        if (!map.is_known(e.x, e.y, e.d)) {
+            unknown = &e;
+            ++unknowns;
+        } else if (!map.has_wall(e.x, e.y, e.d)) {
+            ++open;
+        }
+    }
+    if (open > 0) {
+        for (const auto& e : entrances_) {
+            infer(map, e, true, stats_.center);
+        }
+    } else if (unknowns == 1) {
+        infer(map, *unknown, false, stats_.center);
+    }
+}
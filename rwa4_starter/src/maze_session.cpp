@@ -0,0 +1,206 @@
+#include "maze_session.hpp"
+
+#include <stdexcept>
+
+micro_mouse::MazeBackend& micro_mouse::MazeSession::command_backend() {
+    display_.flush(*backend_, false);
+    return *backend_;
+}
+
+micro_mouse::DisplayCache& micro_mouse::MazeSession::display() {
+    if (!display_.is_sized()) {
+        // Ask in a fixed order, so that traces of the session are repeatable
+        const int width{get_maze_width()};
+        display_.resize(width, get_maze_height());
+    }
+    return display_;
+}
+
+int micro_mouse::MazeSession::get_maze_width() {
+    if (width_ == 0) {
+        width_ = command_backend().maze_width();
+    }
+    return width_;
+}
+
+int micro_mouse::MazeSession::get_maze_height() {
+    if (height_ == 0) {
+        height_ = command_backend().maze_height();
+    }
+    return height_;
+}
+
+bool micro_mouse::MazeSession::has_wall_front() {
+    return command_backend().wall_front();
+}
+
+bool micro_mouse::MazeSession::has_wall_right() {
+    return command_backend().wall_right();
+}
+
+bool micro_mouse::MazeSession::has_wall_left() {
+    return command_backend().wall_left();
+}
+
+void micro_mouse::MazeSession::move_forward(int distance) {
+    const bool check{begin_reset_check()};
+    if (!command_backend().move_forward(distance)) {
+        throw std::runtime_error{"mouse crashed into a wall"};
+    }
+    if (check) {
+        end_reset_check();
+    }
+}
+
+void micro_mouse::MazeSession::turn_right() {
+    const bool check{begin_reset_check()};
+    command_backend().turn_right();
+    if (check) {
+        end_reset_check();
+    }
+}
+
+void micro_mouse::MazeSession::turn_left() {
+    const bool check{begin_reset_check()};
+    command_backend().turn_left();
+    if (check) {
+        end_reset_check();
+    }
+}
+
+void micro_mouse::MazeSession::start_step(const StepRequest& step) {
+    motions_since_check_ += step.turns < 0 ? -step.turns : step.turns;
+    step_check_ = begin_reset_check();
+    command_backend().start_step(step);
+}
+
+micro_mouse::StepReply micro_mouse::MazeSession::finish_step() {
+    const auto reply = backend_->finish_step();
+    if (!reply.moved) {
+        throw std::runtime_error{"mouse crashed into a wall"};
+    }
+    if (step_check_) {
+        end_reset_check();
+    }
+    return reply;
+}
+
+void micro_mouse::MazeSession::set_wall(int x, int y, char direction) {
+    backend_->set_wall(x, y, direction);
+}
+
+void micro_mouse::MazeSession::clear_wall(int x, int y, char direction) {
+    backend_->clear_wall(x, y, direction);
+}
+
+void micro_mouse::MazeSession::set_color(int x, int y, char color) {
+    display().set_color(*backend_, x, y, color);
+}
+
+void micro_mouse::MazeSession::clear_color(int x, int y) {
+    display().clear_color(*backend_, x, y);
+}
+
+void micro_mouse::MazeSession::clear_all_color() {
+    display().clear_all_color(*backend_);
+}
+
+void micro_mouse::MazeSession::set_text(int x, int y, const std::string& text) {
+    display().set_text(*backend_, x, y, text);
+}
+
+void micro_mouse::MazeSession::clear_text(int x, int y) {
+    display().clear_text(*backend_, x, y);
+}
+
+void micro_mouse::MazeSession::clear_all_text() {
+    display().clear_all_text(*backend_);
+}
+
+void micro_mouse::MazeSession::set_marker(int x, int y, char color,
+                                          const std::string& text) {
+    markers_.push_back({x, y, color, text});
+    set_color(x, y, color);
+    set_text(x, y, text);
+}
+
+bool micro_mouse::MazeSession::was_reset() {
+    return command_backend().was_reset();
+}
+
+void micro_mouse::MazeSession::ack_reset() {
+    command_backend().ack_reset();
+}
+
+void micro_mouse::MazeSession::flush() {
+    display_.flush(*backend_, true);
+    backend_->flush();
+}
+
+void micro_mouse::MazeSession::set_display_interval(
+    std::chrono::milliseconds interval) {
+    display_.set_interval(interval);
+}
+
+micro_mouse::ChannelStats micro_mouse::MazeSession::get_channel_stats() {
+    return backend_->get_stats();
+}
+
+micro_mouse::DisplayStats micro_mouse::MazeSession::get_display_stats() {
+    return display_.get_stats();
+}
+
+void micro_mouse::MazeSession::reset_channel_stats() {
+    backend_->reset_stats();
+    display_.reset_stats();
+}
+
+void micro_mouse::MazeSession::set_reset_policy(const ResetPolicy& policy) {
+    reset_policy_ = policy;
+    motions_since_check_ = 0;
+    last_check_ = std::chrono::steady_clock::now();
+}
+
+bool micro_mouse::MazeSession::begin_reset_check() {
+    ++motions_since_check_;
+    const bool by_count{reset_policy_.every_motions > 0 &&
+                        motions_since_check_ >= reset_policy_.every_motions};
+    bool by_time{false};
+    if (!by_count && reset_policy_.interval.count() > 0) {
+        by_time = std::chrono::steady_clock::now() - last_check_ >= reset_policy_.interval;
+    }
+    if (!by_count && !by_time) {
+        return false;
+    }
+    motions_since_check_ = 0;
+    if (reset_policy_.interval.count() > 0) {
+        last_check_ = std::chrono::steady_clock::now();
+    }
+    ++reset_stats_.checks;
+    if (reset_policy_.piggyback) {
+        // Travels in the same write as the motion; its reply is read with
+        // the motion's, so the check adds no round-trip
+        command_backend().queue_was_reset();
+        ++reset_stats_.piggybacked;
+    }
+    return true;
+}
+
+void micro_mouse::MazeSession::end_reset_check() {
+    const bool reset{reset_policy_.piggyback ? backend_->take_was_reset()
+                                             : command_backend().was_reset()};
+    if (reset) {
+        // mms moves the mouse back to the start only now, so the walls
+        // sensed since the button was pressed are still valid
+        command_backend().ack_reset();
+        ++reset_stats_.resets;
+        // What the navigator painted belongs to the run that was cut short;
+        // one command each wipes it, and the next run repaints from there
+        clear_all_color();
+        clear_all_text();
+        for (const auto& marker : markers_) {
+            set_color(marker.x, marker.y, marker.color);
+            set_text(marker.x, marker.y, marker.text);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "maze_simulator.hpp"
+
+void micro_mouse::MazeSimulator::restart() {
+    x_ = 0;
+    y_ = 0;
+    heading_ = Direction::NORTH;
+    reset_requested_ = false;
+    reset_at_move_ = -1;
+    run_stats_ = SimulatorStats{};
+    stats_ = ChannelStats{};
+}
+
+int micro_mouse::MazeSimulator::maze_width() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    return layout_.width;
+}
+
+int micro_mouse::MazeSimulator::maze_height() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    return layout_.height;
+}
+
+bool micro_mouse::MazeSimulator::sense(Direction d) {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    return layout_.has_wall(x_, y_, d);
+}
+
+bool micro_mouse::MazeSimulator::wall_front() {
+    return sense(heading_);
+}
+
+bool micro_mouse::MazeSimulator::wall_right() {
+    return sense(right_of(heading_));
+}
+
+bool micro_mouse::MazeSimulator::wall_left() {
+    return sense(left_of(heading_));
+}
+
+bool micro_mouse::MazeSimulator::move_forward(int distance) {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    for (int step{0}; step < distance; ++step) {
+        if (layout_.has_wall(x_, y_, heading_)) {
+            // mms stops the mouse at the wall and reports a crash
+            ++run_stats_.crashes;
+            return false;
+        }
+        x_ += dx_of(heading_);
+        y_ += dy_of(heading_);
+        ++run_stats_.moves;
+        if (run_stats_.moves == reset_at_move_) {
+            reset_requested_ = true;
+            reset_at_move_ = -1;
+        }
+        if (is_center_cell(x_, y_, layout_.width, layout_.height)) {
+            run_stats_.goal_reached = true;
+        }
+    }
+    return true;
+}
+
+void micro_mouse::MazeSimulator::turn_right() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    heading_ = right_of(heading_);
+    ++run_stats_.turns;
+}
+
+void micro_mouse::MazeSimulator::turn_left() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    heading_ = left_of(heading_);
+    ++run_stats_.turns;
+}
+
+void micro_mouse::MazeSimulator::set_wall(int, int, char) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::clear_wall(int, int, char) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::set_color(int, int, char) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::clear_color(int, int) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::clear_all_color() {
+    post();
+}
+
+void micro_mouse::MazeSimulator::set_text(int, int, const std::string&) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::clear_text(int, int) {
+    post();
+}
+
+void micro_mouse::MazeSimulator::clear_all_text() {
+    post();
+}
+
+bool micro_mouse::MazeSimulator::was_reset() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    return reset_requested_;
+}
+
+void micro_mouse::MazeSimulator::queue_was_reset() {
+    // Answered right away; the next command cannot run before it anyway
+    ++stats_.commands;
+    queued_reset_ = reset_requested_;
+}
+
+void micro_mouse::MazeSimulator::ack_reset() {
+    ++stats_.commands;
+    ++stats_.round_trips;
+    x_ = 0;
+    y_ = 0;
+    heading_ = Direction::NORTH;
+    reset_requested_ = false;
+}
@@ -0,0 +1,130 @@
+#include "mouse.hpp"
+
+#include "maze_api.hpp"
+
+micro_mouse::Mouse::Mouse() : Mouse{MazeControlAPI::get_session()} {}
+
+micro_mouse::Mouse::Mouse(MazeSession& session)
+    : Mouse{session, session.get_maze_width(), session.get_maze_height()} {}
+
+micro_mouse::Mouse::Mouse(MazeSession& session, int width, int height)
+    : session_{session},
+      sensor_{session, width, height},
+      resets_seen_{session.get_reset_stats().resets} {
+    sensor_.get_map().mark_visited(x_, y_);
+}
+
+void micro_mouse::Mouse::learn(const WallMap& map) {
+    sensor_.get_map() = map;
+    sensor_.get_map().mark_visited(x_, y_);
+}
+
+bool micro_mouse::Mouse::has_wall(Direction d) {
+    return sensor_.has_wall(x_, y_, heading_, d);
+}
+
+std::uint8_t micro_mouse::Mouse::sense() {
+    std::uint8_t discovered{0};
+    for (const auto d : {left_of(heading_), heading_, right_of(heading_)}) {
+        const bool known{sensor_.get_map().is_known(x_, y_, d)};
+        if (has_wall(d) && !known) {
+            discovered |= wall_bit(d);
+        }
+    }
+    return discovered;
+}
+
+void micro_mouse::Mouse::move_forward(int distance) {
+    session_.move_forward(distance);
+    for (int step{0}; step < distance; ++step) {
+        x_ += dx_of(heading_);
+        y_ += dy_of(heading_);
+        sensor_.get_map().mark_visited(x_, y_);
+    }
+    follow_reset();
+}
+
+void micro_mouse::Mouse::turn_right() {
+    session_.turn_right();
+    heading_ = right_of(heading_);
+    follow_reset();
+}
+
+void micro_mouse::Mouse::turn_left() {
+    session_.turn_left();
+    heading_ = left_of(heading_);
+    follow_reset();
+}
+
+bool micro_mouse::Mouse::face(Direction d) {
+    const std::size_t resets{resets_seen_};
+    if (d == right_of(heading_)) {
+        turn_right();
+    } else if (d == left_of(heading_)) {
+        turn_left();
+    } else if (d == opposite_of(heading_)) {
+        turn_right();
+        // A reset seen on the first turn left the mouse facing north
+        if (resets_seen_ == resets) {
+            turn_right();
+        }
+    }
+    return resets_seen_ == resets;
+}
+
+std::uint8_t micro_mouse::Mouse::start_step(Direction d, bool sense) {
+    step_ = StepRequest{};
+    if (d == right_of(heading_)) {
+        step_.turns = 1;
+    } else if (d == left_of(heading_)) {
+        step_.turns = -1;
+    } else if (d == opposite_of(heading_)) {
+        step_.turns = 2;
+    }
+    const int x{x_ + dx_of(d)};
+    const int y{y_ + dy_of(d)};
+    std::uint8_t sensed{0};
+    if (sense) {
+        step_.sense_left = sensor_.needs_query(x, y, left_of(d));
+        step_.sense_front = sensor_.needs_query(x, y, d);
+        step_.sense_right = sensor_.needs_query(x, y, right_of(d));
+        sensed = static_cast<std::uint8_t>(
+            (step_.sense_left ? wall_bit(left_of(d)) : 0) |
+            (step_.sense_front ? wall_bit(d) : 0) |
+            (step_.sense_right ? wall_bit(right_of(d)) : 0));
+    }
+    step_heading_ = d;
+    session_.start_step(step_);
+    return sensed;
+}
+
+std::uint8_t micro_mouse::Mouse::finish_step() {
+    last_step_ = session_.finish_step();
+    heading_ = step_heading_;
+    x_ += dx_of(heading_);
+    y_ += dy_of(heading_);
+    sensor_.get_map().mark_visited(x_, y_);
+    std::uint8_t discovered{0};
+    const auto record = [&](bool sensed, Direction d, bool wall) {
+        if (sensed) {
+            sensor_.record(x_, y_, d, wall);
+            discovered = static_cast<std::uint8_t>(discovered | (wall ? wall_bit(d) : 0));
+        }
+    };
+    record(step_.sense_left, left_of(heading_), last_step_.wall_left);
+    record(step_.sense_front, heading_, last_step_.wall_front);
+    record(step_.sense_right, right_of(heading_), last_step_.wall_right);
+    follow_reset();
+    return discovered;
+}
+
+void micro_mouse::Mouse::follow_reset() {
+    const std::size_t resets{session_.get_reset_stats().resets};
+    if (resets == resets_seen_) {
+        return;
+    }
+    resets_seen_ = resets;
+    x_ = 0;
+    y_ = 0;
+    heading_ = Direction::NORTH;
+}
@@ -0,0 +1,376 @@
+#include "navigator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "distance_kernel.hpp"
+#include "maze_memory.hpp"
+#include "maze_session.hpp"
+#include "solver_policy.hpp"
+#include "static_flood_fill.hpp"
+
+namespace {
+// Same moves as explore_with<FloodFillPolicy>, planning each one while the
+// step before it is in flight. The field keeps its own walls, so a copy of
+// it is a complete plan: one copy per possible answer of the queries travelling with the
+// step gets repaired, and the one matching the replies is kept.
+template <int W, int H>
+micro_mouse::RunResult navigate_overlapped(micro_mouse::Mouse& mouse,
+                                           micro_mouse::StaticFloodFill<W, H>& flood,
+                                           bool display, int max_moves) {
+    using namespace micro_mouse;
+    using Clock = std::chrono::steady_clock;
+    // At most three sides are sensed per step, hence 8 outcomes
+    constexpr std::size_t outcomes{8};
+    std::vector<StaticFloodFill<W, H>> plans(outcomes);
+    std::array<MoveChoice, outcomes> choices{};
+    std::array<std::uint8_t, outcomes> walls_of{};
+
+    RunResult result;
+    const auto own_walls = [](const StaticFloodFill<W, H>& field, int x, int y) {
+        return [&field, x, y](Direction d) { return field.has_wall(x, y, d); };
+    };
+    add_walls(flood, mouse.get_x(), mouse.get_y(), mouse.sense());
+    add_inferred_walls(flood, mouse);
+    auto next = choose_move(flood, mouse.get_x(), mouse.get_y(), mouse.get_heading(),
+                            own_walls(flood, mouse.get_x(), mouse.get_y()));
+    int moves{0};
+    while (max_moves == 0 || moves < max_moves) {
+        const int x{mouse.get_x()};
+        const int y{mouse.get_y()};
+        if (is_center_cell(x, y, W, H)) {
+            result.reached_center = true;
+            break;
+        }
+        if (display) {
+            paint_distances(mouse.get_session(), flood, W, H);
+        }
+        if (next.distance == flood.unreachable()) {
+            std::cerr << "No path to the center" << std::endl;
+            break;
+        }
+        const int nx{x + dx_of(next.direction)};
+        const int ny{y + dy_of(next.direction)};
+        // The exploration ends on reaching the center, which needs no sensing
+        const std::uint8_t sensed{mouse.start_step(next.direction,
+                                                   !is_center_cell(nx, ny, W, H))};
+        const auto planning_start = Clock::now();
+        // Subsets in increasing order, each plan being an earlier one plus
+        // its highest wall, so walls go in in the order add_walls() uses.
+        // Once the replies are in, guessing is no longer worth it.
+        std::size_t count{0};
+        std::uint8_t walls{0};
+        do {
+            if (walls == 0) {
+                plans[0] = flood;
+            } else {
+                auto highest = walls;
+                while ((highest & (highest - 1)) != 0) {
+                    highest = static_cast<std::uint8_t>(highest & (highest - 1));
+                }
+                const auto parent = static_cast<std::uint8_t>(walls & ~highest);
+                plans[count] = plans[static_cast<std::size_t>(
+                    std::find(walls_of.begin(), walls_of.begin() + count, parent) -
+                    walls_of.begin())];
+                add_walls(plans[count], nx, ny, highest);
+            }
+            choices[count] = choose_move(plans[count], nx, ny, next.direction,
+                                         own_walls(plans[count], nx, ny));
+            walls_of[count] = walls;
+            ++count;
+            walls = static_cast<std::uint8_t>((walls - sensed) & sensed);
+        } while (walls != 0 && !mouse.get_session().step_answered());
+        const auto speculation_end = Clock::now();
+
+        const std::uint8_t found{mouse.finish_step()};
+        ++moves;
+        const auto planning_end = Clock::now();
+        const std::size_t match{static_cast<std::size_t>(
+            std::find(walls_of.begin(), walls_of.begin() + count, found) - walls_of.begin())};
+        if (match < count) {
+            flood = plans[match];
+            next = choices[match];
+        } else {
+            add_walls(flood, nx, ny, found);
+            next = choose_move(flood, nx, ny, next.direction, own_walls(flood, nx, ny));
+        }
+
+        const auto& step = mouse.get_last_step();
+        const std::chrono::duration<double> speculation = speculation_end - planning_start;
+        const std::chrono::duration<double> hidden =
+            std::min(speculation_end, step.arrived) - std::max(planning_start, step.sent);
+        ++result.overlap.steps;
+        result.overlap.planning_seconds += speculation.count();
+        result.overlap.hidden_seconds += std::max(hidden.count(), 0.0);
+        if (match == count) {
+            const std::chrono::duration<double> late = Clock::now() - planning_end;
+            result.overlap.planning_seconds += late.count();
+        }
+        if (add_inferred_walls(flood, mouse) && mouse.get_x() == nx && mouse.get_y() == ny) {
+            // Deductions are not part of the plans
+            next = choose_move(flood, nx, ny, next.direction, own_walls(flood, nx, ny));
+        }
+        if (mouse.get_x() != nx || mouse.get_y() != ny) {
+            // A reset took the mouse back to the start cell
+            next = choose_move(flood, mouse.get_x(), mouse.get_y(), mouse.get_heading(),
+                               own_walls(flood, mouse.get_x(), mouse.get_y()));
+        }
+    }
+    result.repair = flood.get_stats();
+    result.cells_explored = static_cast<int>(mouse.get_map().visited_count());
+    result.moves = moves;
+    return result;
+}
+}  // namespace
+
+micro_mouse::RunResult micro_mouse::run_flood_fill(Mouse& mouse, bool display,
+                                                   int max_moves) {
+    const auto& map = mouse.get_map();
+    // The field starts from the map, deductions included
+    mouse.clear_inferred();
+    const bool overlap{mouse.get_session().overlaps_steps()};
+    if (map.width() == 16 && map.height() == 16) {
+        if (!overlap) {
+            return explore_with<FloodFillPolicy<StaticFloodFill<16, 16>>>(mouse, display,
+                                                                          max_moves);
+        }
+        StaticFloodFill<16, 16> flood{map};
+        return navigate_overlapped(mouse, flood, display, max_moves);
+    }
+    if (map.width() == 32 && map.height() == 32) {
+        if (!overlap) {
+            return explore_with<FloodFillPolicy<StaticFloodFill<32, 32>>>(mouse, display,
+                                                                          max_moves);
+        }
+        StaticFloodFill<32, 32> flood{map};
+        return navigate_overlapped(mouse, flood, display, max_moves);
+    }
+    return explore_with<FloodFillPolicy<FloodFill>>(mouse, display, max_moves);
+}
+
+micro_mouse::PathBounds micro_mouse::path_bounds(const WallMap& map) {
+    const auto center = center_seeds(map.width(), map.height());
+    std::vector<int> distances;
+    std::vector<std::uint8_t> nearest;
+    compute_distances(map, center, true, distances);
+    PathBounds bounds;
+    bounds.optimistic = distances[0];
+    compute_nearest_goals(map, center, false, distances, nearest);
+    bounds.pessimistic = distances[0];
+    // Goal ids count the center cells row by row
+    int goal{0};
+    for (int y{0}; y < map.height(); ++y) {
+        for (int x{0}; x < map.width(); ++x) {
+            if (is_center_cell(x, y, map.width(), map.height()) && goal++ == nearest[0]) {
+                bounds.goal_x = x;
+                bounds.goal_y = y;
+            }
+        }
+    }
+    return bounds;
+}
+
+namespace {
+// Cells of row y with a side not observed yet
+std::uint64_t unknown_sides(const micro_mouse::WallMap& map, int y) {
+    const std::uint64_t east{map.unknown_east(y)};
+    std::uint64_t unknown{map.unknown_north(y) | east | (east << 1)};
+    if (y > 0) {
+        unknown |= map.unknown_north(y - 1);
+    }
+    return unknown & map.row_mask();
+}
+}  // namespace
+
+micro_mouse::RunResult micro_mouse::run_two_bound(Mouse& mouse, bool display,
+                                                  int max_moves) {
+    const auto& map = mouse.get_map();
+    const int width{map.width()};
+    const int height{map.height()};
+    const auto center = center_seeds(width, height);
+    const auto start = single_cell_goal(height, 0, 0);
+    std::vector<int> to_center;
+    std::vector<int> to_center_known;
+    std::vector<int> from_start;
+    std::vector<int> to_target;
+    std::vector<std::uint64_t> targets(static_cast<std::size_t>(height));
+    RunResult result;
+    int moves{0};
+    while (true) {
+        const int x{mouse.get_x()};
+        const int y{mouse.get_y()};
+        // The whole cell is known from here on, so it is never a target
+        mouse.sense();
+        mouse.clear_inferred();
+        compute_distances(map, center, true, to_center);
+        compute_distances(map, center, false, to_center_known);
+        result.bounds.optimistic = to_center[0];
+        result.bounds.pessimistic = to_center_known[0];
+        if (display) {
+            paint_distances(mouse.get_session(), DistanceView{to_center, width, height},
+                            width, height);
+        }
+        if (result.bounds.met() || (max_moves != 0 && moves >= max_moves)) {
+            break;
+        }
+        // A route is as short as the lower bound if its cells are
+        compute_distances(map, start, true, from_start);
+        for (int ty{0}; ty < height; ++ty) {
+            std::uint64_t on_route{0};
+            for (int tx{0}; tx < width; ++tx) {
+                const auto i = static_cast<std::size_t>(ty * width + tx);
+                if (from_start[i] + to_center[i] == result.bounds.optimistic) {
+                    on_route |= std::uint64_t{1} << tx;
+                }
+            }
+            targets[static_cast<std::size_t>(ty)] = on_route & unknown_sides(map, ty);
+        }
+        compute_distances(map, targets, true, to_target);
+        const auto best = choose_move(DistanceView{to_target, width, height}, x, y,
+                                      mouse.get_heading(),
+                                      [&](Direction d) { return map.has_wall(x, y, d); });
+        if (best.distance == width * height) {
+            break;
+        }
+        if (!mouse.face(best.direction)) {
+            // A reset took the mouse back to the start: replan from there
+            continue;
+        }
+        mouse.move_forward();
+        ++moves;
+    }
+    result.reached_center = result.bounds.pessimistic < width * height;
+    if (!result.reached_center) {
+        std::cerr << "No path to the center" << std::endl;
+    }
+    result.cells_explored = static_cast<int>(map.visited_count());
+    result.moves = moves;
+    return result;
+}
+
+namespace {
+// Speed-run to the center, starting over if a reset sends the mouse back
+void race_to_center(micro_mouse::Mouse& mouse, micro_mouse::RunResult& result) {
+    using namespace micro_mouse;
+    const auto& map = mouse.get_map();
+    do {
+        result.speed_run = plan_speed_run(map, mouse.get_x(), mouse.get_y(),
+                                          mouse.get_heading(),
+                                          center_seeds(map.width(), map.height()));
+    } while (!execute_plan(mouse, result.speed_run));
+}
+
+// Explore from the current pose, return to the start and do the speed run
+micro_mouse::RunResult explore_and_race(micro_mouse::Mouse& mouse, bool display,
+                                        int max_moves,
+                                        micro_mouse::Exploration exploration,
+                                        micro_mouse::Explorer explorer) {
+    using namespace micro_mouse;
+    const auto& map = mouse.get_map();
+    RunResult result = exploration == Exploration::PROVE_SHORTEST
+                           ? run_two_bound(mouse, display, max_moves)
+                           : explorer(mouse, display, max_moves);
+    result.sensing = mouse.get_sensing_stats();
+    result.inference = mouse.get_inference_stats();
+    result.bounds = path_bounds(map);
+    if (!result.reached_center) {
+        return result;
+    }
+    const auto back = plan_speed_run(map, mouse.get_x(), mouse.get_y(),
+                                     mouse.get_heading(),
+                                     single_cell_goal(map.height(), 0, 0));
+    // A reset on the way back leaves the mouse on the start cell anyway
+    execute_plan(mouse, back);
+    race_to_center(mouse, result);
+    return result;
+}
+
+// Check that every edge the mouse has seen is recorded the same way in a
+// learned map
+bool agrees_with(const micro_mouse::WallMap& seen, const micro_mouse::WallMap& learned) {
+    const auto& known = seen.get_known().words();
+    const auto& walls = seen.get_walls().words();
+    const auto& learned_known = learned.get_known().words();
+    const auto& learned_walls = learned.get_walls().words();
+    for (std::size_t i{0}; i < known.size(); ++i) {
+        if ((known[i] & ~learned_known[i]) != 0 ||
+            ((walls[i] ^ learned_walls[i]) & known[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
+micro_mouse::RunResult micro_mouse::run_mouse(MazeSession& session, bool display,
+                                              int max_moves, bool maze_rules,
+                                              Exploration exploration,
+                                              Explorer explorer) {
+    Mouse mouse{session};
+    if (maze_rules) {
+        mouse.use_maze_rules();
+    }
+    return explore_and_race(mouse, display, max_moves, exploration, explorer);
+}
+
+micro_mouse::RunResult micro_mouse::run_mouse_with_memory(MazeSession& session,
+                                                          bool display, int max_moves,
+                                                          const std::string& memory_file,
+                                                          bool maze_rules,
+                                                          Exploration exploration,
+                                                          Explorer explorer) {
+    Mouse mouse{session};
+    if (maze_rules) {
+        mouse.use_maze_rules();
+    }
+    const auto& map = mouse.get_map();
+    const auto learned = load_learned_maze(memory_file, map.width(), map.height());
+    RunResult result;
+    if (learned) {
+        // Explore one move at a time until the maze is recognizable
+        int moves{0};
+        while (!mouse.get_fingerprint().complete() &&
+               (max_moves == 0 || moves < max_moves)) {
+            const int x{mouse.get_x()};
+            const int y{mouse.get_y()};
+            const auto step = run_flood_fill(mouse, display, 1);
+            result.repair.walls += step.repair.walls;
+            result.repair.cells_touched += step.repair.cells_touched;
+            result.moves += step.moves;
+            if (step.reached_center || (x == mouse.get_x() && y == mouse.get_y())) {
+                break;
+            }
+            ++moves;
+        }
+        if (mouse.get_fingerprint().hash == learned->key &&
+            agrees_with(map, learned->map)) {
+            result.cells_explored = static_cast<int>(map.visited_count());
+            mouse.learn(learned->map);
+            race_to_center(mouse, result);
+            if (result.speed_run.reachable) {
+                result.reached_center = true;
+                result.warm_start = true;
+                result.sensing = mouse.get_sensing_stats();
+                result.inference = mouse.get_inference_stats();
+                result.bounds = path_bounds(map);
+                return result;
+            }
+        }
+    }
+    // No usable memory: explore from here and remember this maze
+    const RepairStats probe{result.repair};
+    const int probe_moves{result.moves};
+    result = explore_and_race(mouse, display, max_moves, exploration, explorer);
+    result.repair.walls += probe.walls;
+    result.repair.cells_touched += probe.cells_touched;
+    result.moves += probe_moves;
+    if (result.reached_center) {
+        save_learned_maze(memory_file, mouse.get_fingerprint().hash, mouse.get_map());
+    }
+    return result;
+}
@@ -0,0 +1,168 @@
+#include "protocol_server.hpp"
+
+#include <sstream>
+
+#include "binary_framing.hpp"
+
+namespace {
+const char* to_reply(bool value) {
+    return value ? "true" : "false";
+}
+
+char to_byte(bool value) {
+    return value ? '\1' : '\0';
+}
+}  // namespace
+
+bool micro_mouse::ProtocolServer::handle(std::string_view line,
+                                         std::string& reply) {
+    std::istringstream fields{std::string{line}};
+    std::string command;
+    fields >> command;
+    int x{0};
+    int y{0};
+    if (command == "mazeWidth") {
+        reply = std::to_string(backend_.maze_width());
+        if (offer_binary_ && backend_.maze_width() <= binary_max_side &&
+            backend_.maze_height() <= binary_max_side) {
+            reply += ' ';
+            reply += binary_offer;
+        }
+    } else if (offer_binary_ && command == binary_request) {
+        binary_ = true;
+        reply = "ack";
+    } else if (command == "mazeHeight") {
+        reply = std::to_string(backend_.maze_height());
+    } else if (command == "wallFront") {
+        reply = to_reply(backend_.wall_front());
+    } else if (command == "wallRight") {
+        reply = to_reply(backend_.wall_right());
+    } else if (command == "wallLeft") {
+        reply = to_reply(backend_.wall_left());
+    } else if (command == "moveForward") {
+        int distance{1};
+        fields >> distance;
+        reply = backend_.move_forward(distance) ? "ack" : "crash";
+    } else if (command == "turnRight" || command == "turnRight90") {
+        backend_.turn_right();
+        reply = "ack";
+    } else if (command == "turnLeft" || command == "turnLeft90") {
+        backend_.turn_left();
+        reply = "ack";
+    } else if (command == "wasReset") {
+        reply = to_reply(backend_.was_reset());
+    } else if (command == "ackReset") {
+        backend_.ack_reset();
+        reply = "ack";
+    } else {
+        // Commands without a reply
+        char argument{' '};
+        if (command == "setWall" && fields >> x >> y >> argument) {
+            backend_.set_wall(x, y, argument);
+        } else if (command == "clearWall" && fields >> x >> y >> argument) {
+            backend_.clear_wall(x, y, argument);
+        } else if (command == "setColor" && fields >> x >> y >> argument) {
+            backend_.set_color(x, y, argument);
+        } else if (command == "clearColor" && fields >> x >> y) {
+            backend_.clear_color(x, y);
+        } else if (command == "clearAllColor") {
+            backend_.clear_all_color();
+        } else if (command == "setText" && fields >> x >> y) {
+            std::string text;
+            fields >> text;
+            backend_.set_text(x, y, text);
+        } else if (command == "clearText" && fields >> x >> y) {
+            backend_.clear_text(x, y);
+        } else if (command == "clearAllText") {
+            backend_.clear_all_text();
+        }
+        return false;
+    }
+    return true;
+}
+
+std::size_t micro_mouse::ProtocolServer::handle_frame(std::string_view bytes,
+                                                     std::string& reply) {
+    reply.clear();
+    if (bytes.empty()) {
+        return 0;
+    }
+    const auto op = static_cast<FrameOp>(bytes[0]);
+    const std::size_t size{frame_size(op)};
+    if (size == 0) {
+        return 1;
+    }
+    if (bytes.size() < size) {
+        return 0;
+    }
+    const auto byte = [&bytes](std::size_t i) {
+        return static_cast<int>(static_cast<unsigned char>(bytes[i]));
+    };
+    switch (op) {
+    case FrameOp::MAZE_WIDTH:
+        reply.push_back(static_cast<char>(backend_.maze_width()));
+        break;
+    case FrameOp::MAZE_HEIGHT:
+        reply.push_back(static_cast<char>(backend_.maze_height()));
+        break;
+    case FrameOp::WALL_FRONT:
+        reply.push_back(to_byte(backend_.wall_front()));
+        break;
+    case FrameOp::WALL_RIGHT:
+        reply.push_back(to_byte(backend_.wall_right()));
+        break;
+    case FrameOp::WALL_LEFT:
+        reply.push_back(to_byte(backend_.wall_left()));
+        break;
+    case FrameOp::MOVE_FORWARD:
+        reply.push_back(to_byte(backend_.move_forward(byte(1))));
+        break;
+    case FrameOp::TURN_RIGHT:
+        backend_.turn_right();
+        reply.push_back(to_byte(true));
+        break;
+    case FrameOp::TURN_LEFT:
+        backend_.turn_left();
+        reply.push_back(to_byte(true));
+        break;
+    case FrameOp::SET_WALL:
+        backend_.set_wall(byte(1), byte(2), bytes[3]);
+        break;
+    case FrameOp::CLEAR_WALL:
+        backend_.clear_wall(byte(1), byte(2), bytes[3]);
+        break;
+    case FrameOp::SET_COLOR:
+        backend_.set_color(byte(1), byte(2), bytes[3]);
+        break;
+    case FrameOp::CLEAR_COLOR:
+        backend_.clear_color(byte(1), byte(2));
+        break;
+    case FrameOp::CLEAR_ALL_COLOR:
+        backend_.clear_all_color();
+        break;
+    case FrameOp::SET_TEXT: {
+        // The text follows its length
+        const auto length = static_cast<std::size_t>(byte(3));
+        if (bytes.size() < size + length) {
+            return 0;
+        }
+        text_.assign(bytes.substr(size, length));
+        backend_.set_text(byte(1), byte(2), text_);
+        return size + length;
+    }
+    case FrameOp::CLEAR_TEXT:
+        backend_.clear_text(byte(1), byte(2));
+        break;
+    case FrameOp::CLEAR_ALL_TEXT:
+        backend_.clear_all_text();
+        break;
+    case FrameOp::WAS_RESET:
+        reply.push_back(to_byte(backend_.was_reset()));
+        break;
+    case FrameOp::ACK_RESET:
+        backend_.ack_reset();
+        reply.push_back(to_byte(true));
+        break;
+    }
+    return size;
+}
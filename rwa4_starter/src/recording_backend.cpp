@@ -0,0 +1,171 @@
+#include "recording_backend.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+micro_mouse::RecordingBackend::RecordingBackend(MazeBackend& inner,
+                                                const std::string& path)
+    : inner_{inner},
+      out_{path, std::ios::binary | std::ios::trunc},
+      origin_{Clock::now()} {
+    if (!out_) {
+        throw std::runtime_error{"cannot create trace file " + path};
+    }
+    out_.write(trace_magic, sizeof trace_magic);
+}
+
+void micro_mouse::RecordingBackend::record(Clock::time_point start, TraceOp op,
+                                           int value, int x, int y, char argument,
+                                           std::string_view text) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    const auto wait = duration_cast<nanoseconds>(Clock::now() - start).count();
+    TraceRecord entry;
+    entry.time_ns = static_cast<std::uint64_t>(
+        duration_cast<nanoseconds>(start - origin_).count());
+    entry.wait_ns = static_cast<std::uint32_t>(std::min<long long>(
+        wait, std::numeric_limits<std::uint32_t>::max()));
+    entry.value = value;
+    entry.x = static_cast<std::int16_t>(x);
+    entry.y = static_cast<std::int16_t>(y);
+    entry.op = op;
+    entry.argument = argument;
+    entry.text_length = static_cast<std::uint16_t>(
+        std::min<std::size_t>(text.size(), std::numeric_limits<std::uint16_t>::max()));
+    out_.write(reinterpret_cast<const char*>(&entry), sizeof entry);
+    out_.write(text.data(), entry.text_length);
+}
+
+int micro_mouse::RecordingBackend::maze_width() {
+    const auto start = Clock::now();
+    const int value{inner_.maze_width()};
+    record(start, TraceOp::MAZE_WIDTH, value);
+    return value;
+}
+
+int micro_mouse::RecordingBackend::maze_height() {
+    const auto start = Clock::now();
+    const int value{inner_.maze_height()};
+    record(start, TraceOp::MAZE_HEIGHT, value);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::wall_front() {
+    const auto start = Clock::now();
+    const bool value{inner_.wall_front()};
+    record(start, TraceOp::WALL_FRONT, value ? 1 : 0);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::wall_right() {
+    const auto start = Clock::now();
+    const bool value{inner_.wall_right()};
+    record(start, TraceOp::WALL_RIGHT, value ? 1 : 0);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::wall_left() {
+    const auto start = Clock::now();
+    const bool value{inner_.wall_left()};
+    record(start, TraceOp::WALL_LEFT, value ? 1 : 0);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::was_reset() {
+    const auto start = Clock::now();
+    const bool value{inner_.was_reset()};
+    record(start, TraceOp::WAS_RESET, value ? 1 : 0);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::take_was_reset() {
+    const auto start = Clock::now();
+    const bool value{inner_.take_was_reset()};
+    record(start, TraceOp::TAKE_WAS_RESET, value ? 1 : 0);
+    return value;
+}
+
+bool micro_mouse::RecordingBackend::move_forward(int distance) {
+    const auto start = Clock::now();
+    const bool moved{inner_.move_forward(distance)};
+    record(start, TraceOp::MOVE_FORWARD, moved ? 1 : 0, distance);
+    return moved;
+}
+
+void micro_mouse::RecordingBackend::turn_right() {
+    const auto start = Clock::now();
+    inner_.turn_right();
+    record(start, TraceOp::TURN_RIGHT);
+}
+
+void micro_mouse::RecordingBackend::turn_left() {
+    const auto start = Clock::now();
+    inner_.turn_left();
+    record(start, TraceOp::TURN_LEFT);
+}
+
+void micro_mouse::RecordingBackend::set_wall(int x, int y, char direction) {
+    const auto start = Clock::now();
+    inner_.set_wall(x, y, direction);
+    record(start, TraceOp::SET_WALL, 0, x, y, direction);
+}
+
+void micro_mouse::RecordingBackend::clear_wall(int x, int y, char direction) {
+    const auto start = Clock::now();
+    inner_.clear_wall(x, y, direction);
+    record(start, TraceOp::CLEAR_WALL, 0, x, y, direction);
+}
+
+void micro_mouse::RecordingBackend::set_color(int x, int y, char color) {
+    const auto start = Clock::now();
+    inner_.set_color(x, y, color);
+    record(start, TraceOp::SET_COLOR, 0, x, y, color);
+}
+
+void micro_mouse::RecordingBackend::clear_color(int x, int y) {
+    const auto start = Clock::now();
+    inner_.clear_color(x, y);
+    record(start, TraceOp::CLEAR_COLOR, 0, x, y);
+}
+
+void micro_mouse::RecordingBackend::clear_all_color() {
+    const auto start = Clock::now();
+    inner_.clear_all_color();
+    record(start, TraceOp::CLEAR_ALL_COLOR);
+}
+
+void micro_mouse::RecordingBackend::set_text(int x, int y, const std::string& text) {
+    const auto start = Clock::now();
+    inner_.set_text(x, y, text);
+    record(start, TraceOp::SET_TEXT, 0, x, y, 0, text);
+}
+
+void micro_mouse::RecordingBackend::clear_text(int x, int y) {
+    const auto start = Clock::now();
+    inner_.clear_text(x, y);
+    record(start, TraceOp::CLEAR_TEXT, 0, x, y);
+}
+
+void micro_mouse::RecordingBackend::clear_all_text() {
+    const auto start = Clock::now();
+    inner_.clear_all_text();
+    record(start, TraceOp::CLEAR_ALL_TEXT);
+}
+
+void micro_mouse::RecordingBackend::ack_reset() {
+    const auto start = Clock::now();
+    inner_.ack_reset();
+    record(start, TraceOp::ACK_RESET);
+}
+
+void micro_mouse::RecordingBackend::queue_was_reset() {
+    const auto start = Clock::now();
+    inner_.queue_was_reset();
+    record(start, TraceOp::QUEUE_WAS_RESET);
+}
+
+void micro_mouse::RecordingBackend::flush() {
+    inner_.flush();
+    out_.flush();
+}
@@ -0,0 +1,142 @@
+#include "replay_backend.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+micro_mouse::ReplayBackend::ReplayBackend(const std::string& path) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error{"cannot open trace file " + path};
+    }
+    const std::vector<char> data{std::istreambuf_iterator<char>{in},
+                                 std::istreambuf_iterator<char>{}};
+    if (data.size() < sizeof trace_magic ||
+        std::memcmp(data.data(), trace_magic, sizeof trace_magic) != 0) {
+        throw std::runtime_error{path + " is not a trace file"};
+    }
+    std::size_t position{sizeof trace_magic};
+    while (position + sizeof(TraceRecord) <= data.size()) {
+        TraceRecord entry;
+        std::memcpy(&entry, data.data() + position, sizeof entry);
+        position += sizeof entry + entry.text_length;
+        const double end{static_cast<double>(entry.time_ns + entry.wait_ns) * 1e-9};
+        recorded_seconds_ = std::max(recorded_seconds_, end);
+        recorded_wait_seconds_ += static_cast<double>(entry.wait_ns) * 1e-9;
+        if (!is_display_op(entry.op)) {
+            replies_.push_back(entry);
+        }
+    }
+}
+
+void micro_mouse::ReplayBackend::rewind() noexcept {
+    next_ = 0;
+}
+
+const micro_mouse::TraceRecord& micro_mouse::ReplayBackend::expect(TraceOp op) {
+    if (next_ == replies_.size()) {
+        throw std::runtime_error{"the solver went past the end of the trace"};
+    }
+    const TraceRecord& entry = replies_[next_];
+    if (entry.op != op) {
+        throw std::runtime_error{"the solver diverged from the trace at call " +
+                                 std::to_string(next_)};
+    }
+    ++next_;
+    ++stats_.commands;
+    ++stats_.round_trips;
+    return entry;
+}
+
+int micro_mouse::ReplayBackend::maze_width() {
+    return expect(TraceOp::MAZE_WIDTH).value;
+}
+
+int micro_mouse::ReplayBackend::maze_height() {
+    return expect(TraceOp::MAZE_HEIGHT).value;
+}
+
+bool micro_mouse::ReplayBackend::wall_front() {
+    return expect(TraceOp::WALL_FRONT).value != 0;
+}
+
+bool micro_mouse::ReplayBackend::wall_right() {
+    return expect(TraceOp::WALL_RIGHT).value != 0;
+}
+
+bool micro_mouse::ReplayBackend::wall_left() {
+    return expect(TraceOp::WALL_LEFT).value != 0;
+}
+
+bool micro_mouse::ReplayBackend::move_forward(int distance) {
+    const TraceRecord& entry = expect(TraceOp::MOVE_FORWARD);
+    if (entry.x != distance) {
+        throw std::runtime_error{"the solver diverged from the trace at call " +
+                                 std::to_string(next_ - 1)};
+    }
+    return entry.value != 0;
+}
+
+void micro_mouse::ReplayBackend::turn_right() {
+    expect(TraceOp::TURN_RIGHT);
+}
+
+void micro_mouse::ReplayBackend::turn_left() {
+    expect(TraceOp::TURN_LEFT);
+}
+
+void micro_mouse::ReplayBackend::set_wall(int, int, char) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::clear_wall(int, int, char) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::set_color(int, int, char) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::clear_color(int, int) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::clear_all_color() {
+    post();
+}
+
+void micro_mouse::ReplayBackend::set_text(int, int, const std::string&) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::clear_text(int, int) {
+    post();
+}
+
+void micro_mouse::ReplayBackend::clear_all_text() {
+    post();
+}
+
+bool micro_mouse::ReplayBackend::was_reset() {
+    return expect(TraceOp::WAS_RESET).value != 0;
+}
+
+void micro_mouse::ReplayBackend::ack_reset() {
+    expect(TraceOp::ACK_RESET);
+}
+
+void micro_mouse::ReplayBackend::queue_was_reset() {
+    expect(TraceOp::QUEUE_WAS_RESET);
+    // Travels with the next command, as over the text protocol
+    --stats_.round_trips;
+}
+
+bool micro_mouse::ReplayBackend::take_was_reset() {
+    const TraceRecord& entry = expect(TraceOp::TAKE_WAS_RESET);
+    // The command count was taken when the check was queued
+    --stats_.commands;
+    --stats_.round_trips;
+    return entry.value != 0;
+}
@@ -0,0 +1,116 @@
+#include "serial_link.hpp"
+
+#include <unistd.h>
+
+#include <charconv>
+
+#include "command_line.hpp"
+
+namespace {
+// Write all of [data, data + size), retrying short writes
+bool write_all(int fd, const char* data, std::size_t size) noexcept {
+    while (size > 0) {
+        const ssize_t written{::write(fd, data, size)};
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+int parse_int(std::string_view token) noexcept {
+    int value{0};
+    std::from_chars(token.data(), token.data() + token.size(), value);
+    return value;
+}
+}  // namespace
+
+int micro_mouse::SerialLink::maze_width() noexcept {
+    return parse_int(request("mazeWidth"));
+}
+
+int micro_mouse::SerialLink::maze_height() noexcept {
+    return parse_int(request("mazeHeight"));
+}
+
+bool micro_mouse::SerialLink::wall_front() noexcept {
+    return request("wallFront") == "true";
+}
+
+bool micro_mouse::SerialLink::wall_right() noexcept {
+    return request("wallRight") == "true";
+}
+
+bool micro_mouse::SerialLink::wall_left() noexcept {
+    return request("wallLeft") == "true";
+}
+
+bool micro_mouse::SerialLink::move_forward() noexcept {
+    const std::string_view reply{request("moveForward")};
+    if (reply != "ack") {
+        log(reply);
+        return false;
+    }
+    return true;
+}
+
+void micro_mouse::SerialLink::turn_right() noexcept {
+    request("turnRight");
+}
+
+void micro_mouse::SerialLink::turn_left() noexcept {
+    request("turnLeft");
+}
+
+void micro_mouse::SerialLink::set_wall(int x, int y, char direction) noexcept {
+    post(CommandLine{"setWall", x, y}.append(direction).view());
+}
+
+void micro_mouse::SerialLink::flush() noexcept {
+    if (output_size_ > 0 && open_) {
+        open_ = write_all(out_fd_, output_.data(), output_size_);
+    }
+    output_size_ = 0;
+}
+
+void micro_mouse::SerialLink::log(std::string_view text) noexcept {
+    write_all(STDERR_FILENO, text.data(), text.size());
+    write_all(STDERR_FILENO, "\n", 1);
+}
+
+void micro_mouse::SerialLink::post(std::string_view line) noexcept {
+    if (output_size_ + line.size() + 1 > output_.size()) {
+        flush();
+    }
+    for (const char c : line) {
+        output_[output_size_++] = c;
+    }
+    output_[output_size_++] = '\n';
+}
+
+std::string_view micro_mouse::SerialLink::request(std::string_view line) noexcept {
+    post(line);
+    flush();
+    std::size_t size{0};
+    while (open_) {
+        if (input_begin_ == input_end_) {
+            const ssize_t got{::read(in_fd_, input_.data(), input_.size())};
+            if (got <= 0) {
+                open_ = false;
+                break;
+            }
+            input_begin_ = 0;
+            input_end_ = static_cast<std::size_t>(got);
+        }
+        const char c{input_[input_begin_++]};
+        if (c == '\n') {
+            return {reply_.data(), size};
+        }
+        if (size < reply_.size()) {
+            reply_[size++] = c;
+        }
+    }
+    return {};
+}
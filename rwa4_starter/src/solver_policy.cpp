@@ -0,0 +1,202 @@
+#include "solver_policy.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "distance_kernel.hpp"
+
+std::optional<micro_mouse::Direction> micro_mouse::DfsBacktracking::next(
+    const Mouse& mouse) {
+    const int x{mouse.get_x()};
+    const int y{mouse.get_y()};
+    if (mouse.get_reset_count() != resets_) {
+        // A reset took the mouse back to the start cell: walk the path
+        // again, over edges known to be open, and carry on from its end
+        resets_ = mouse.get_reset_count();
+        replayed_ = 0;
+    }
+    if (replayed_ < path_.size()) {
+        return path_[replayed_++];
+    }
+    const Direction heading{mouse.get_heading()};
+    std::optional<Direction> forward;
+    int best{0};
+    for (const auto d :
+         {heading, left_of(heading), right_of(heading), opposite_of(heading)}) {
+        const int nx{x + dx_of(d)};
+        const int ny{y + dy_of(d)};
+        if (map_.has_wall(x, y, d) || map_.is_visited(nx, ny)) {
+            continue;
+        }
+        const int distance{crow_distance(nx, ny, map_.width(), map_.height())};
+        if (!forward || distance < best) {
+            forward = d;
+            best = distance;
+        }
+    }
+    if (forward) {
+        path_.push_back(*forward);
+        ++replayed_;
+        return forward;
+    }
+    if (!path_.empty()) {
+        const Direction d{opposite_of(path_.back())};
+        path_.pop_back();
+        --replayed_;
+        left_x_ = x;
+        left_y_ = y;
+        return d;
+    }
+    // Every cell reachable from the start has been searched
+    return std::nullopt;
+}
+
+void micro_mouse::DfsBacktracking::paint(MazeSession& session) {
+    if (left_x_ >= 0) {
+        session.clear_color(left_x_, left_y_);
+        left_x_ = -1;
+    }
+    int x{0};
+    int y{0};
+    for (const auto d : path_) {
+        session.set_color(x, y, 'c');
+        x += dx_of(d);
+        y += dy_of(d);
+    }
+}
+
+micro_mouse::FrontierExplorer::FrontierExplorer(Mouse& mouse)
+    : map_{mouse.get_map()},
+      flood_{map_},
+      frontier_{static_cast<std::size_t>(map_.width() * map_.height()),
+                map_.width() * map_.height()},
+      seeds_(static_cast<std::size_t>(map_.height())) {
+    flood_.track_changes(true);
+    // The field starts from the map, deductions included
+    mouse.clear_inferred();
+    for (int y{0}; y < map_.height(); ++y) {
+        for (int x{0}; x < map_.width(); ++x) {
+            for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                                 Direction::WEST}) {
+                add_frontier(x, y, d);
+            }
+        }
+    }
+}
+
+void micro_mouse::FrontierExplorer::add_frontier(int x, int y, Direction d) {
+    const int nx{x + dx_of(d)};
+    const int ny{y + dy_of(d)};
+    if (map_.is_visited(x, y) && map_.is_open(x, y, d) && !map_.is_visited(nx, ny)) {
+        frontier_.push(ny * map_.width() + nx, flood_.distance(nx, ny));
+    }
+}
+
+void micro_mouse::FrontierExplorer::observe(Mouse& mouse, std::uint8_t walls) {
+    const int x{mouse.get_x()};
+    const int y{mouse.get_y()};
+    frontier_.erase(y * map_.width() + x);
+    add_walls(flood_, x, y, walls);
+    for (const auto& inferred : mouse.get_inferred()) {
+        const auto& e = inferred.edge;
+        if (inferred.wall) {
+            flood_.add_wall(e.x, e.y, e.d);
+        } else {
+            add_frontier(e.x, e.y, e.d);
+            add_frontier(e.x + dx_of(e.d), e.y + dy_of(e.d), opposite_of(e.d));
+        }
+    }
+    mouse.clear_inferred();
+    for (const auto d :
+         {Direction::NORTH, Direction::EAST, Direction::SOUTH, Direction::WEST}) {
+        add_frontier(x, y, d);
+    }
+    // Only the cells the walls pushed further from the center need a new key
+    for (const int cell : flood_.get_changes()) {
+        if (frontier_.contains(cell)) {
+            frontier_.push(cell, flood_.distance(cell % map_.width(), cell / map_.width()));
+        }
+    }
+    flood_.clear_changes();
+}
+
+std::optional<micro_mouse::Direction> micro_mouse::FrontierExplorer::next(
+    const Mouse& mouse) {
+    const int width{map_.width()};
+    const int height{map_.height()};
+    const int unreachable{width * height};
+    const int x{mouse.get_x()};
+    const int y{mouse.get_y()};
+    std::fill(seeds_.begin(), seeds_.end(), 0);
+    seeds_[static_cast<std::size_t>(y)] = std::uint64_t{1} << x;
+    compute_distances(map_, seeds_, false, travel_);
+
+    // Every frontier cell is at least one move away, so once the distance
+    // to the center alone reaches the best cost, no further cell can win;
+    // on a tie, the cell closer to the center is kept
+    int target{-1};
+    int best{unreachable * 2};
+    for (int cell{frontier_.first()}; cell >= 0; cell = frontier_.next(cell)) {
+        const int to_center{frontier_.key(cell)};
+        if (to_center == unreachable || to_center + 1 >= best) {
+            break;
+        }
+        const int travel{travel_[static_cast<std::size_t>(cell)]};
+        if (travel != unreachable && travel + to_center < best) {
+            best = travel + to_center;
+            target = cell;
+        }
+    }
+    if (target < 0) {
+        return std::nullopt;
+    }
+    // Walk back from the target to the cell next to the mouse, downhill in
+    // travel distance, keeping straight where the route allows
+    int cx{target % width};
+    int cy{target / width};
+    Direction back{Direction::NORTH};
+    const auto travel_at = [&](int tx, int ty) {
+        return travel_[static_cast<std::size_t>(ty * width + tx)];
+    };
+    while (travel_at(cx, cy) > 1) {
+        for (const auto d : {back, left_of(back), right_of(back), opposite_of(back)}) {
+            if (map_.is_open(cx, cy, d) &&
+                travel_at(cx + dx_of(d), cy + dy_of(d)) == travel_at(cx, cy) - 1) {
+                cx += dx_of(d);
+                cy += dy_of(d);
+                back = d;
+                break;
+            }
+        }
+    }
+    for (const auto d : {Direction::NORTH, Direction::EAST, Direction::SOUTH,
+                         Direction::WEST}) {
+        if (x + dx_of(d) == cx && y + dy_of(d) == cy) {
+            return d;
+        }
+    }
+    return std::nullopt;
+}
+
+const std::array<micro_mouse::SolverEntry, 4>& micro_mouse::solver_registry() noexcept {
+    static const std::array<SolverEntry, 4> registry{{
+        {"flood-fill", run_flood_fill},
+        {"wall-follower", explore_with<WallFollower>},
+        {"dfs", explore_with<DfsBacktracking>},
+        {"frontier", explore_with<FrontierExplorer>},
+    }};
+    return registry;
+}
+
+micro_mouse::Explorer micro_mouse::find_solver(std::string_view name) {
+    std::string names;
+    for (const auto& entry : solver_registry()) {
+        if (entry.name == name) {
+            return entry.explore;
+        }
+        names += names.empty() ? "" : ", ";
+        names += entry.name;
+    }
+    throw std::invalid_argument{"unknown solver " + std::string{name} + " (" + names + ")"};
+}
@@ -0,0 +1,113 @@
+#include "speed_run.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+micro_mouse::SpeedRunPlan micro_mouse::plan_speed_run(
+    const WallMap& map, int x, int y, Direction heading,
+    const std::vector<std::uint64_t>& goals, const MotionCost& cost) {
+    const int width{map.width()};
+    const auto states = static_cast<std::size_t>(width * map.height() * 4);
+    const auto state_of = [width](int cx, int cy, Direction d) {
+        return static_cast<std::size_t>((cy * width + cx) * 4 + static_cast<int>(d));
+    };
+    const auto is_goal = [&goals](int cx, int cy) {
+        return ((goals[static_cast<std::size_t>(cy)] >> cx) & 1U) != 0;
+    };
+
+    std::vector<double> times(states, std::numeric_limits<double>::infinity());
+    std::vector<std::size_t> parents(states, states);
+    std::vector<Motion> via(states);
+    using Entry = std::pair<double, std::size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+
+    const std::size_t start{state_of(x, y, heading)};
+    times[start] = 0.0;
+    open.emplace(0.0, start);
+    std::size_t reached{states};
+    while (!open.empty()) {
+        const auto [time, state] = open.top();
+        open.pop();
+        if (time > times[state]) {
+            continue;
+        }
+        const int cell{static_cast<int>(state / 4)};
+        const int cx{cell % width};
+        const int cy{cell / width};
+        const auto d = static_cast<Direction>(state % 4);
+        if (is_goal(cx, cy)) {
+            reached = state;
+            break;
+        }
+        const auto relax = [&](std::size_t next, double next_time, Motion motion) {
+            if (next_time < times[next]) {
+                times[next] = next_time;
+                parents[next] = state;
+                via[next] = motion;
+                open.emplace(next_time, next);
+            }
+        };
+        relax(state_of(cx, cy, left_of(d)), time + cost.turn_time,
+              Motion{Motion::Kind::TURN_LEFT, 0});
+        relax(state_of(cx, cy, right_of(d)), time + cost.turn_time,
+              Motion{Motion::Kind::TURN_RIGHT, 0});
+        int nx{cx};
+        int ny{cy};
+        for (int cells{1}; map.is_open(nx, ny, d); ++cells) {
+            nx += dx_of(d);
+            ny += dy_of(d);
+            relax(state_of(nx, ny, d),
+                  time + cost.straight_overhead + cells * cost.cell_time,
+                  Motion{Motion::Kind::FORWARD, cells});
+        }
+    }
+
+    SpeedRunPlan plan;
+    if (reached == states) {
+        return plan;
+    }
+    plan.reachable = true;
+    plan.time = times[reached];
+    for (std::size_t state{reached}; state != start; state = parents[state]) {
+        plan.motions.push_back(via[state]);
+        if (via[state].kind == Motion::Kind::FORWARD) {
+            plan.cells += via[state].cells;
+        } else {
+            ++plan.turns;
+        }
+    }
+    std::reverse(plan.motions.begin(), plan.motions.end());
+    plan.cell_by_cell_time = plan.cells * (cost.straight_overhead + cost.cell_time) +
+                             plan.turns * cost.turn_time;
+    return plan;
+}
+
+bool micro_mouse::execute_plan(Mouse& mouse, const SpeedRunPlan& plan) {
+    const std::size_t resets{mouse.get_reset_count()};
+    for (const auto& motion : plan.motions) {
+        switch (motion.kind) {
+            case Motion::Kind::FORWARD:
+                mouse.move_forward(motion.cells);
+                break;
+            case Motion::Kind::TURN_LEFT:
+                mouse.turn_left();
+                break;
+            case Motion::Kind::TURN_RIGHT:
+                mouse.turn_right();
+                break;
+        }
+        if (mouse.get_reset_count() != resets) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::uint64_t> micro_mouse::single_cell_goal(int height, int x, int y) {
+    std::vector<std::uint64_t> goal(static_cast<std::size_t>(height), 0);
+    goal[static_cast<std::size_t>(y)] = std::uint64_t{1} << x;
+    return goal;
+}
@@ -0,0 +1,295 @@
+#include "stream_backend.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "command_line.hpp"
+
+namespace {
+using micro_mouse::CommandLine;
+
+// moveForward line; the distance is left out when it is 1, for backwards
+// compatibility with older versions of the simulator
+CommandLine move_line(int distance) {
+    CommandLine line{"moveForward"};
+    if (distance != 1) {
+        line.append(distance);
+    }
+    return line;
+}
+
+// Builds one binary frame in place. Coordinates and lengths take a byte
+// each; text longer than the buffer is cut, as for CommandLine.
+class Frame {
+public:
+    explicit Frame(micro_mouse::FrameOp op) { put(static_cast<std::uint8_t>(op)); }
+
+    Frame(micro_mouse::FrameOp op, int x, int y) : Frame{op} {
+        append(x);
+        append(y);
+    }
+
+    Frame& append(int value) {
+        put(static_cast<std::uint8_t>(value));
+        return *this;
+    }
+
+    Frame& append(char c) {
+        put(static_cast<std::uint8_t>(c));
+        return *this;
+    }
+
+    Frame& append_text(std::string_view text) {
+        const std::size_t length{std::min(text.size(), data_.size() - size_ - 1)};
+        append(static_cast<int>(length));
+        for (const char c : text.substr(0, length)) {
+            append(c);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] std::string_view view() const { return {data_.data(), size_}; }
+
+private:
+    void put(std::uint8_t byte) {
+        if (size_ < data_.size()) {
+            data_[size_++] = static_cast<char>(byte);
+        }
+    }
+
+    std::array<char, 96> data_{};
+    std::size_t size_{0};
+};
+
+// Every opcode as a one-byte frame, for the commands without arguments
+constexpr auto opcodes = [] {
+    std::array<char, 32> bytes{};
+    for (std::size_t i{0}; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>(i);
+    }
+    return bytes;
+}();
+
+int parse_int(std::string_view token) {
+    int value{0};
+    std::from_chars(token.data(), token.data() + token.size(), value);
+    return value;
+}
+}  // namespace
+
+std::string_view micro_mouse::StreamBackend::command(
+    FrameOp op, std::string_view text) const noexcept {
+    if (!channel_.is_binary()) {
+        return text;
+    }
+    return {&opcodes[static_cast<std::size_t>(op)], 1};
+}
+
+std::string_view micro_mouse::StreamBackend::request_move(int distance) {
+    if (channel_.is_binary()) {
+        return channel_.request(Frame{FrameOp::MOVE_FORWARD}.append(distance).view());
+    }
+    return channel_.request(move_line(distance).view());
+}
+
+void micro_mouse::StreamBackend::send_move(int distance) {
+    if (channel_.is_binary()) {
+        channel_.send(Frame{FrameOp::MOVE_FORWARD}.append(distance).view());
+    } else {
+        channel_.send(move_line(distance).view());
+    }
+}
+
+bool micro_mouse::StreamBackend::says(std::string_view reply,
+                                      std::string_view word) const noexcept {
+    if (channel_.is_binary()) {
+        return reply.size() == 1 && reply[0] == 1;
+    }
+    return reply == word;
+}
+
+int micro_mouse::StreamBackend::to_int(std::string_view reply) const noexcept {
+    if (channel_.is_binary()) {
+        return reply.empty() ? 0 : static_cast<unsigned char>(reply[0]);
+    }
+    return parse_int(reply);
+}
+
+void micro_mouse::StreamBackend::report_crash(std::string_view reply) const {
+    if (channel_.is_binary()) {
+        std::cerr << "crash" << std::endl;
+    } else {
+        std::cerr << reply << std::endl;
+    }
+}
+
+int micro_mouse::StreamBackend::maze_width() {
+    const int width{to_int(channel_.request(command(FrameOp::MAZE_WIDTH, "mazeWidth")))};
+    if (accept_binary_ && !channel_.is_binary()) {
+        // A stand-in offering binary frames names them after the width
+        const std::string_view reply{channel_.get_last_reply()};
+        const std::size_t offer{reply.find(' ')};
+        if (offer != std::string_view::npos && reply.substr(offer + 1) == binary_offer &&
+            channel_.request(binary_request) == "ack") {
+            channel_.set_binary(true);
+        }
+    }
+    return width;
+}
+
+int micro_mouse::StreamBackend::maze_height() {
+    return to_int(channel_.request(command(FrameOp::MAZE_HEIGHT, "mazeHeight")));
+}
+
+bool micro_mouse::StreamBackend::wall_front() {
+    return says(channel_.request(command(FrameOp::WALL_FRONT, "wallFront")), "true");
+}
+
+bool micro_mouse::StreamBackend::wall_right() {
+    return says(channel_.request(command(FrameOp::WALL_RIGHT, "wallRight")), "true");
+}
+
+bool micro_mouse::StreamBackend::wall_left() {
+    return says(channel_.request(command(FrameOp::WALL_LEFT, "wallLeft")), "true");
+}
+
+bool micro_mouse::StreamBackend::move_forward(int distance) {
+    const std::string_view response = request_move(distance);
+    if (!says(response, "ack")) {
+        report_crash(response);
+        return false;
+    }
+    return true;
+}
+
+void micro_mouse::StreamBackend::turn_right() {
+    channel_.request(command(FrameOp::TURN_RIGHT, "turnRight"));
+}
+
+void micro_mouse::StreamBackend::turn_left() {
+    channel_.request(command(FrameOp::TURN_LEFT, "turnLeft"));
+}
+
+void micro_mouse::StreamBackend::set_wall(int x, int y, char direction) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::SET_WALL, x, y}.append(direction).view());
+        return;
+    }
+    channel_.post(CommandLine{"setWall", x, y}.append(direction).view());
+}
+
+void micro_mouse::StreamBackend::clear_wall(int x, int y, char direction) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::CLEAR_WALL, x, y}.append(direction).view());
+        return;
+    }
+    channel_.post(CommandLine{"clearWall", x, y}.append(direction).view());
+}
+
+void micro_mouse::StreamBackend::set_color(int x, int y, char color) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::SET_COLOR, x, y}.append(color).view());
+        return;
+    }
+    channel_.post(CommandLine{"setColor", x, y}.append(color).view());
+}
+
+void micro_mouse::StreamBackend::clear_color(int x, int y) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::CLEAR_COLOR, x, y}.view());
+        return;
+    }
+    channel_.post(CommandLine{"clearColor", x, y}.view());
+}
+
+void micro_mouse::StreamBackend::clear_all_color() {
+    channel_.post(command(FrameOp::CLEAR_ALL_COLOR, "clearAllColor"));
+}
+
+void micro_mouse::StreamBackend::set_text(int x, int y, const std::string& text) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::SET_TEXT, x, y}.append_text(text).view());
+        return;
+    }
+    channel_.post(CommandLine{"setText", x, y}.append(std::string_view{text}).view());
+}
+
+void micro_mouse::StreamBackend::clear_text(int x, int y) {
+    if (channel_.is_binary()) {
+        channel_.post(Frame{FrameOp::CLEAR_TEXT, x, y}.view());
+        return;
+    }
+    channel_.post(CommandLine{"clearText", x, y}.view());
+}
+
+void micro_mouse::StreamBackend::clear_all_text() {
+    channel_.post(command(FrameOp::CLEAR_ALL_TEXT, "clearAllText"));
+}
+
+bool micro_mouse::StreamBackend::was_reset() {
+    return says(channel_.request(command(FrameOp::WAS_RESET, "wasReset")), "true");
+}
+
+void micro_mouse::StreamBackend::ack_reset() {
+    channel_.request(command(FrameOp::ACK_RESET, "ackReset"));
+}
+
+void micro_mouse::StreamBackend::queue_was_reset() {
+    channel_.defer_request(command(FrameOp::WAS_RESET, "wasReset"));
+}
+
+bool micro_mouse::StreamBackend::take_was_reset() {
+    return says(channel_.take_deferred_reply(), "true");
+}
+
+void micro_mouse::StreamBackend::start_step(const StepRequest& step) {
+    pending_step_ = step;
+    if (!overlap_steps_) {
+        return;
+    }
+    for (int turn{0}; turn < step.turns; ++turn) {
+        channel_.send(command(FrameOp::TURN_RIGHT, "turnRight"));
+    }
+    for (int turn{0}; turn > step.turns; --turn) {
+        channel_.send(command(FrameOp::TURN_LEFT, "turnLeft"));
+    }
+    send_move(step.distance);
+    // mms answers in order, so the queries see the mouse after the move
+    if (step.sense_left) {
+        channel_.send(command(FrameOp::WALL_LEFT, "wallLeft"));
+    }
+    if (step.sense_front) {
+        channel_.send(command(FrameOp::WALL_FRONT, "wallFront"));
+    }
+    if (step.sense_right) {
+        channel_.send(command(FrameOp::WALL_RIGHT, "wallRight"));
+    }
+    channel_.flush();
+    step_sent_ = std::chrono::steady_clock::now();
+}
+
+micro_mouse::StepReply micro_mouse::StreamBackend::finish_step() {
+    if (!overlap_steps_) {
+        return MazeBackend::finish_step();
+    }
+    StepReply reply;
+    reply.sent = step_sent_;
+    for (int turn{0}; turn < std::abs(pending_step_.turns); ++turn) {
+        channel_.receive();
+    }
+    const std::string_view response = channel_.receive();
+    reply.moved = says(response, "ack");
+    if (!reply.moved) {
+        report_crash(response);
+    }
+    // Queries sent after a crash are answered from where the mouse stopped
+    reply.wall_left = pending_step_.sense_left && says(channel_.receive(), "true");
+    reply.wall_front = pending_step_.sense_front && says(channel_.receive(), "true");
+    reply.wall_right = pending_step_.sense_right && says(channel_.receive(), "true");
+    reply.arrived = channel_.get_reply_time();
+    return reply;
+}
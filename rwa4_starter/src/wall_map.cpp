@@ -0,0 +1,59 @@
+#include "wall_map.hpp"
+
+#include <stdexcept>
+
+micro_mouse::WallMap::WallMap(int width, int height)
+    : width_{width},
+      height_{height},
+      vertical_base_{static_cast<std::size_t>(width * (height + 1))} {
+    if (width < 1 || width > 64 || height < 1) {
+        throw std::invalid_argument{"maze must be 1 to 64 cells wide and at least 1 cell high"};
+    }
+    const std::size_t edges{vertical_base_ +
+                            static_cast<std::size_t>((width + 1) * height)};
+    walls_ = BitArray{edges};
+    known_ = BitArray{edges};
+    visited_ = BitArray{static_cast<std::size_t>(width * height)};
+
+    // The maze is fully enclosed
+    for (int x{0}; x < width_; ++x) {
+        set_wall(x, 0, Direction::SOUTH, true);
+        set_wall(x, height_ - 1, Direction::NORTH, true);
+    }
+    for (int y{0}; y < height_; ++y) {
+        set_wall(0, y, Direction::WEST, true);
+        set_wall(width_ - 1, y, Direction::EAST, true);
+    }
+}
+
+bool micro_mouse::WallMap::set_wall(int x, int y, Direction d, bool wall) {
+    const std::size_t e{edge_index(x, y, d)};
+    const bool was_known{known_.test(e)};
+    known_.set(e);
+    walls_.set(e, wall);
+    return !was_known;
+}
+
+std::size_t micro_mouse::WallMap::edge_index(int x, int y,
+                                             Direction d) const noexcept {
+    switch (d) {
+        case Direction::NORTH:
+            return static_cast<std::size_t>((y + 1) * width_ + x);
+        case Direction::SOUTH:
+            return static_cast<std::size_t>(y * width_ + x);
+        case Direction::EAST:
+            return vertical_base_ + static_cast<std::size_t>(y * (width_ + 1) + x + 1);
+        case Direction::WEST:
+        default:
+            return vertical_base_ + static_cast<std::size_t>(y * (width_ + 1) + x);
+    }
+}
+
+std::uint64_t micro_mouse::WallMap::open_bits(std::size_t pos,
+                                              bool optimistic) const noexcept {
+    const std::uint64_t walls{walls_.extract(pos, row_bits())};
+    if (optimistic) {
+        return ~walls & row_mask();
+    }
+    return known_.extract(pos, row_bits()) & ~walls;
+}
@@ -0,0 +1,85 @@
+#include "wall_sensor.hpp"
+
+#include "maze_session.hpp"
+
+bool micro_mouse::WallSensor::has_wall(int x, int y, Direction heading,
+                                       Direction d) {
+    if (!needs_query(x, y, d)) {
+        return map_.has_wall(x, y, d);
+    }
+    if (d == opposite_of(heading)) {
+        return false;
+    }
+    bool wall{false};
+    if (d == heading) {
+        wall = session_.has_wall_front();
+    } else if (d == left_of(heading)) {
+        wall = session_.has_wall_left();
+    } else {
+        wall = session_.has_wall_right();
+    }
+    record(x, y, d, wall);
+    return wall;
+}
+
+bool micro_mouse::WallSensor::needs_query(int x, int y, Direction d) {
+    if (map_.is_known(x, y, d)) {
+        ++stats_.avoided;
+        return false;
+    }
+    return true;
+}
+
+void micro_mouse::WallSensor::record(int x, int y, Direction d, bool wall) {
+    ++stats_.queries;
+    fingerprint_.add(x, y, d, wall);
+    map_.set_wall(x, y, d, wall);
+    if (wall) {
+        session_.set_wall(x, y, to_char(d));
+    }
+    if (rules_) {
+        infer_from(x, y, d);
+    }
+}
+
+void micro_mouse::WallSensor::use_maze_rules() {
+    if (rules_) {
+        return;
+    }
+    rules_.emplace(map_.width(), map_.height());
+    rules_->seed(map_);
+    show_inferred(0);
+}
+
+void micro_mouse::WallSensor::infer_from(int x, int y, Direction d) {
+    const std::size_t before{rules_->get_inferred().size()};
+    rules_->propagate(map_, Edge{x, y, d});
+    show_inferred(before);
+}
+
+void micro_mouse::WallSensor::show_inferred(std::size_t first) {
+    const auto& inferred = rules_->get_inferred();
+    for (std::size_t i{first}; i < inferred.size(); ++i) {
+        if (inferred[i].wall) {
+            const auto& edge = inferred[i].edge;
+            session_.set_wall(edge.x, edge.y, to_char(edge.d));
+        }
+    }
+}
+
+const std::vector<micro_mouse::InferredEdge>& micro_mouse::WallSensor::get_inferred()
+    const noexcept {
+    static const std::vector<InferredEdge> none;
+    return rules_ ? rules_->get_inferred() : none;
+}
+
+void micro_mouse::WallSensor::clear_inferred() noexcept {
+    if (rules_) {
+        rules_->clear_inferred();
+    }
+}
+
+micro_mouse::InferenceStats micro_mouse::WallSensor::get_inference_stats()
+    const noexcept {
+    return rules_ ? rules_->get_stats() : InferenceStats{};
+}